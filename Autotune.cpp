@@ -0,0 +1,245 @@
+// solver choice for a problem by timing short probe searches of each candidate configuration
+// Bill Ola Rasmussen
+
+#include "Autotune.h"
+#include "Watchdog.h"
+#include "dlx2.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <memory>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <random>
+#include <algorithm>
+#include <iomanip>
+using namespace std;
+
+namespace {
+
+const double SAMPLE_SECONDS(0.2); // the first candidate takes samples until their search takes this long
+const double PROBE_SECONDS(1.0); // or the cut goes deeper once it takes this long
+const size_t MOST_SUBTREES(size_t(1) << 20);
+
+using Clock = chrono::steady_clock;
+
+double Seconds(const Clock::time_point begin)
+{
+	return chrono::duration<double>(Clock::now() - begin).count();
+}
+
+// solver output during the probes would bury their results
+ostream quiet(nullptr);
+
+const char* PropagateName(const Solver::Propagate p)
+{
+	return Solver::Propagate::Off == p ? "off" : Solver::Propagate::Forced == p ? "forced" : "rows";
+}
+
+string Secs(const double seconds)
+{
+	ostringstream s;
+	s << fixed << setprecision(3) << seconds << " s";
+	return s.str();
+}
+
+string Text(const Tuning& t)
+{
+	return t.solver + " propagate=" + PropagateName(t.propagate) + " endgame=" + to_string(t.endgame);
+}
+
+string Shape(const ProblemMatrix& pm, const bool counting)
+{
+	ostringstream s;
+	s << pm.Primary() << ' ' << pm.Secondary() << ' ' << pm.Rows() << ' ' << pm.Nodes() << ' ' << pm.PrimaryWidth() << ' ' << (counting ? "count" : "show");
+	return s.str();
+}
+
+const size_t SHAPE_FIELDS(6);
+
+// the last choice for the shape in the cache file, false if none
+bool Cached(const string& cacheFile, const string& shape, Tuning& t)
+{
+	ifstream in(cacheFile);
+	bool hit(false);
+	for (string line; getline(in, line);) {
+		if (line.empty() || '#' == line[0]) { continue; }
+		istringstream s(line);
+		string key, field, propagate;
+		for (size_t i(0); i < SHAPE_FIELDS && s >> field; ++i) { key += (i ? " " : "") + field; }
+		Tuning c;
+		if (!(s >> c.solver >> propagate >> c.endgame)) { throw(runtime_error("bad line in tuning cache " + cacheFile + ": " + line)); }
+		if (key != shape) { continue; }
+		if ("off" == propagate) { c.propagate = Solver::Propagate::Off; }
+		else if ("forced" == propagate) { c.propagate = Solver::Propagate::Forced; }
+		else if ("rows" == propagate) { c.propagate = Solver::Propagate::Rows; }
+		else { throw(runtime_error("bad propagate mode in tuning cache " + cacheFile + ": " + line)); }
+		t = c;
+		hit = true;
+	}
+	return hit;
+}
+
+void Remember(const string& cacheFile, const string& shape, const Tuning& t)
+{
+	const bool fresh(!ifstream(cacheFile));
+	ofstream out(cacheFile, ios::app);
+	if (fresh) { out << "# solver choices of solve auto: primary secondary rows nodes widest count|show, solver propagate endgame\n"; }
+	out << shape << ' ' << t.solver << ' ' << PropagateName(t.propagate) << ' ' << t.endgame << '\n';
+	if (!out) { cout << "auto: unable to write tuning cache " << cacheFile << '\n'; }
+}
+
+// the problem below a partial solution: the columns it covers, rows clashing
+// with it and rows left without a primary column removed
+ProblemMatrix Residual(const ProblemMatrix& pm, const Solver::Soln& rows)
+{
+	typedef ProblemMatrix::TI TI;
+	const TI GONE(numeric_limits<TI>::max());
+	vector<TI> id(pm.Cols(), 0);
+	for (const auto& r : rows) {
+		for (auto p(pm.RowBegin(r)); p != pm.RowEnd(r); ++p) { id[*p] = GONE; }
+	}
+	TI pc(0), sc(0);
+	for (TI c(0); c < pm.Cols(); ++c) {
+		if (GONE != id[c]) { id[c] = c < pm.Primary() ? pc++ : sc++; }
+	}
+	for (TI c(pm.Primary()); c < pm.Cols(); ++c) {
+		if (GONE != id[c]) { id[c] += pc; }
+	}
+	ProblemMatrix::Offsets start(1, 0);
+	ProblemMatrix::Indices col;
+	for (TI r(0); r < pm.Rows(); ++r) {
+		const size_t begin(col.size());
+		bool primary(false), clash(false);
+		for (auto p(pm.RowBegin(r)); p != pm.RowEnd(r) && !clash; ++p) {
+			clash = GONE == id[*p];
+			primary = primary || *p < pm.Primary();
+			col.push_back(id[*p]);
+		}
+		if (clash || !primary) { col.resize(begin); }
+		else { start.push_back(col.size()); }
+	}
+	return ProblemMatrix(pc, sc, move(start), move(col));
+}
+
+// search time of candidate t on the samples, stopped is set if it took over
+// limit seconds; with more, samples are added until they take enough seconds
+double Probe(vector<ProblemMatrix>& sample, const Tuning& t, const bool counting, BuildSolver& build, const double limit, bool& stopped,
+	function<bool()> more = nullptr, const double enough = 0)
+{
+	atomic<bool> stop(false);
+	double seconds(0);
+	Watchdog dog(stop, limit); // one deadline for the searches of all samples
+	auto paused(Clock::now()); // time outside the searches moves the deadline
+	for (size_t i(0); !stop && (i < sample.size() || (seconds < enough && more && more())); ++i) {
+		unique_ptr<Solver> solver(build(sample[i], t.solver, quiet)); // build time of the samples does not count
+		solver->propagate = t.propagate;
+		solver->endgame = t.endgame;
+		solver->stop = &stop;
+		const auto begin(Clock::now());
+		dog.Extend(chrono::duration<double>(begin - paused).count());
+		solver->Solve(counting ? Solver::Show() : Solver::Show([](const Solver::Soln&) {}), [](Solver::Event) {});
+		paused = Clock::now();
+		seconds += chrono::duration<double>(paused - begin).count();
+	}
+	stopped = stop;
+	return seconds;
+}
+
+} // namespace
+
+Tuning Autotune(const ProblemMatrix& pm, const bool counting, const string& cacheFile, BuildSolver build)
+{
+	const string shape(Shape(pm, counting));
+	Tuning chosen;
+	if (Cached(cacheFile, shape, chosen)) {
+		cout << "auto: " << Text(chosen) << ", cached for this problem shape in " << cacheFile << '\n';
+		return chosen;
+	}
+
+	typedef Solver::Propagate P;
+	const vector<Tuning> candidate{
+		{ "dix", P::Off, 32 }, { "dix", P::Off, 0 }, { "dix", P::Forced, 32 }, { "dix", P::Forced, 0 },
+		{ "dlx2", P::Off, 32 }, { "dlx2", P::Off, 0 }, { "dlx2", P::Forced, 32 }, { "dlx2", P::Forced, 0 },
+		{ "dlx", P::Off, 0 }, { "acx", P::Off, 0 }, { "dcx", P::Off, 0 },
+	};
+	map<string, double> buildTime;
+	for (const auto& c : candidate) {
+		if (buildTime.count(c.solver)) { continue; }
+		const auto begin(Clock::now());
+		{
+			const unique_ptr<Solver> built(build(pm, c.solver, quiet)); // freed within the timing too
+		}
+		buildTime[c.solver] = Seconds(begin);
+	}
+
+	// cut the tree deeper until the first candidate searches its samples in time
+	DLX2 cutter(pm);
+	vector<Solver::Soln> subtree(1); // partial solutions at the cut, at depth 0 the whole problem
+	size_t depth(0), want(64);
+	vector<ProblemMatrix> sample;
+	bool stopped(false);
+	double searched(0);
+	for (;;) {
+		bool deeper(false);
+		while (subtree.size() < want && subtree.size() < MOST_SUBTREES) {
+			vector<Solver::Soln> next;
+			cutter.BeginSteps(Solver::Soln(), Solver::Soln(), true, depth + 1, false);
+			for (DLX2::Stop s; DLX2::Stop::Done != (s = cutter.Step());) {
+				if (DLX2::Stop::Prefix == s) { next.emplace_back(cutter.Current()); }
+			}
+			if (next.empty()) { break; } // the tree ends above, keep this cut
+			subtree.swap(next);
+			++depth;
+			deeper = true;
+		}
+		if (!deeper && !sample.empty()) { break; } // no smaller subtrees to be had
+		sample.clear();
+		vector<size_t> order(subtree.size()); // samples in random order, the same each run
+		iota(order.begin(), order.end(), 0);
+		shuffle(order.begin(), order.end(), minstd_rand(1));
+		auto more([&]
+		{
+			if (sample.size() == subtree.size()) { return false; }
+			sample.push_back(Residual(pm, subtree[order[sample.size()]]));
+			return true;
+		});
+		searched = Probe(sample, candidate[0], counting, build, PROBE_SECONDS, stopped, more, SAMPLE_SECONDS);
+		if (!stopped || subtree.size() >= MOST_SUBTREES) { break; }
+		want = 16 * subtree.size();
+	}
+	const double scale(double(subtree.size()) / sample.size());
+	cout << "auto: probing " << sample.size() << " of " << subtree.size() << " subtrees at depth " << depth << '\n';
+
+	auto report([&](const Tuning& c, const double projected)
+	{
+		cout << "auto: " << Text(c) << ": build " << Secs(buildTime[c.solver]) << ", projected " << Secs(projected) << '\n';
+	});
+	double best(buildTime[candidate[0].solver] + searched * scale); // a stopped first candidate still sets the bar
+	chosen = candidate[0];
+	report(chosen, best);
+	for (size_t i(1); i < candidate.size(); ++i) {
+		const Tuning& c(candidate[i]);
+		const double limit((best - buildTime[c.solver]) / scale); // sample search time to beat the best
+		if (limit <= 0) {
+			cout << "auto: " << Text(c) << ": build " << Secs(buildTime[c.solver]) << ", not faster\n";
+			continue;
+		}
+		const double seconds(Probe(sample, c, counting, build, limit, stopped));
+		if (stopped) {
+			cout << "auto: " << Text(c) << ": build " << Secs(buildTime[c.solver]) << ", samples over " << Secs(limit) << ", not faster\n";
+			continue;
+		}
+		const double projected(buildTime[c.solver] + seconds * scale);
+		report(c, projected);
+		if (projected < best) {
+			best = projected;
+			chosen = c;
+		}
+	}
+	cout << "auto: chose " << Text(chosen) << '\n';
+	Remember(cacheFile, shape, chosen);
+	return chosen;
+}
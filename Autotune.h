@@ -0,0 +1,38 @@
+// solver choice for a problem by timing short probe searches of each candidate configuration
+// Bill Ola Rasmussen
+#pragma once
+
+#include "Solver.h"
+#include "ProblemMatrix.h"
+#include <string>
+#include <functional>
+
+// The search tree is cut at a shallow depth into subtrees, the partial
+// solutions found there, and subtrees are sampled in random order until the
+// first candidate has searched them for a fraction of a second. Each sample
+// becomes a problem of its own: the columns its rows cover and the rows
+// clashing with them removed. Every candidate, a solver with its propagate
+// and endgame settings, is built on the whole problem for its build time,
+// then searches the samples. Projected total time: build time plus sample
+// search time scaled by subtrees over samples. A candidate is stopped once
+// its samples take longer than the best so far allows. If one sample takes
+// too long the cut goes deeper.
+//
+// Candidates: dlx, acx and dcx as they are, dlx2 and dix with propagate off
+// and forced and endgame 0 and 32. Index widths are the narrowest that fit.
+//
+// The choice is kept in a cache file, one line per problem shape: primary
+// and secondary column counts, rows, nodes, widest row and whether the
+// solutions are shown or only counted, then the chosen solver, propagate
+// mode and endgame. A problem of a cached shape is not probed again.
+
+struct Tuning {
+	std::string solver;
+	Solver::Propagate propagate;
+	unsigned int endgame;
+};
+
+using BuildSolver = std::function<Solver*(const ProblemMatrix&, const std::string& solverName, std::ostream& out)>; // out: as in Solvers.h
+
+// counting: the run counts solutions without showing them, as with -q
+Tuning Autotune(const ProblemMatrix& pm, const bool counting, const std::string& cacheFile, BuildSolver build);
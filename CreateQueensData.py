@@ -79,8 +79,20 @@ def exactCoverSpec(n):
 			print(' '.join(map(str,b.constraints(x,y))))
 	print(']')
 	
+def rowArrays(n):
+	'rows for the solver library: constraint counts, column numbers back to back and row lengths, see exactcover.py'
+	import array
+	b=Board(n)
+	cols,lengths=array.array('i'),array.array('i')
+	for x in range(n):
+		for y in range(n):
+			r=b.constraints(x,y)
+			cols.extend(r)
+			lengths.append(len(r))
+	return b.constraintCounts(),cols,lengths
+	
 def runTests():
-	print('usage: '+sys.argv[0]+' [board size]')
+	print('usage: '+sys.argv[0]+' [board size] [-o file[.gz|.zst]]')
 	import platform
 	print('python version '+platform.python_version())
 	print('running unit tests...')
@@ -90,8 +102,12 @@ def runTests():
 
 if __name__ == "__main__":
 	import sys
-	if len(sys.argv) == 2:
-		exactCoverSpec(int(sys.argv[1]))
+	import contextlib
+	import compressedFile
+	args,fileName=compressedFile.takeOutput(sys.argv[1:]) # -o file: write there, .gz or .zst compressed
+	if len(args) == 1:
+		with compressedFile.openOutput(fileName) as f, contextlib.redirect_stdout(f):
+			exactCoverSpec(int(args[0]))
 	else:
 		runTests()
 
@@ -39,10 +39,15 @@ def tileOrientations():
                 y=[-n for n in y] # reflect across X axis
                 yield list(zip(x,y))
 
+def metadata(b):
+    'solver readable description: board cells are the columns, cell x,y is column x+w*y'
+    return 'meta: width='+str(b.w)+' height='+str(b.h)+' piece=5'
+
 def explain(b):
     'describe file data'
     s='A generalized exact cover specification for the Y Pentomino cover problem.\n'\
       +str(b)+'\n'\
+      +metadata(b)+'\n'\
       'First digit: number of primary constraints "exactly one".\n'\
       'Second digit: number of secondary constraints "at most one".\n'\
       'Each line after the first two digits describes a unique Y Pentomino position.\n'\
@@ -59,9 +64,18 @@ def exactCoverSpec(w,h):
         print(' '.join(map(str,z)))
     print(']')
 
+def rowArrays(w,h):
+    'rows for the solver library: constraint counts and column numbers back to back, 5 per row, see exactcover.py'
+    import array
+    b=Board(w,h)
+    cols=array.array('i')
+    for z in b.constraints():
+        cols.extend(z)
+    return b.constraintCounts(),cols
+
 def runTests():
-    print('usage: '+sys.argv[0]+' [board size] or')
-    print('       '+sys.argv[0]+' [width] [height]')
+    print('usage: '+sys.argv[0]+' [board size] [-o file[.gz|.zst]] or')
+    print('       '+sys.argv[0]+' [width] [height] [-o file[.gz|.zst]]')
     import platform
     print('python version '+platform.python_version())
     print('running unit tests...')
@@ -71,9 +85,11 @@ def runTests():
 
 if __name__ == "__main__":
     import sys
-    if len(sys.argv) == 2:
-        exactCoverSpec(int(sys.argv[1]),int(sys.argv[1])) # square
-    elif len(sys.argv) == 3:
-        exactCoverSpec(int(sys.argv[1]),int(sys.argv[2]))
+    import contextlib
+    import compressedFile
+    args,fileName=compressedFile.takeOutput(sys.argv[1:]) # -o file: write there, .gz or .zst compressed
+    if len(args) in (1,2):
+        with compressedFile.openOutput(fileName) as f, contextlib.redirect_stdout(f):
+            exactCoverSpec(int(args[0]),int(args[-1])) # one size: square
     else:
         runTests()
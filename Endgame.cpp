@@ -0,0 +1,154 @@
+// bitmask endgame: finish a small residual exact cover problem with word-parallel row sets
+// Bill Ola Rasmussen
+
+#include "Endgame.h"
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+using namespace std;
+
+namespace {
+
+unsigned int LowBit(const Endgame::Mask m) // index of the lowest set bit, m != 0
+{
+#ifdef _MSC_VER
+	unsigned long i;
+	_BitScanForward64(&i, m);
+	return i;
+#else
+	return __builtin_ctzll(m);
+#endif
+}
+
+unsigned int Ones(const Endgame::Mask m)
+{
+#ifdef _MSC_VER
+	return unsigned(__popcnt64(m));
+#else
+	return __builtin_popcountll(m);
+#endif
+}
+
+} // namespace
+
+void Endgame::Clear(const size_t columns, const size_t nodes)
+{
+	if (_bit.size() < columns) { _bit.resize(columns, -1); }
+	if (_seen.size() < nodes) { _seen.resize(nodes); }
+	++_pass;
+	for (const auto& c : _mapped) { _bit[c] = -1; }
+	_mapped.clear();
+	_mask.clear();
+	_id.clear();
+}
+
+bool Endgame::Map(const size_t col, Mask& m)
+{
+	int& b(_bit[col]);
+	if (b < 0) {
+		if (BITS == _mapped.size()) { return false; }
+		b = int(_mapped.size());
+		_mapped.push_back(col);
+	}
+	m |= Mask(1) << b;
+	return true;
+}
+
+bool Endgame::Add(const Mask m, const size_t id)
+{
+	if (ROWS == _mask.size()) { return false; }
+	_mask.push_back(m);
+	_id.push_back(id);
+	return true;
+}
+
+void Endgame::Start(const Mask primary, const bool bulk, const atomic<bool>* stop)
+{
+	_primary = primary;
+	_bulk = bulk;
+	_stop = stop;
+	const Rows none = {};
+	for (unsigned int b(0); b < _mapped.size(); ++b) { _col[b] = none; }
+	for (size_t k(0); k < _mask.size(); ++k) {
+		for (Mask m(_mask[k]); m; m &= m - 1) { _col[LowBit(m)].w[k / 64] |= Mask(1) << k % 64; }
+	}
+	_conflict.assign(_mask.size(), none);
+	for (size_t k(0); k < _mask.size(); ++k) {
+		for (Mask m(_mask[k]); m; m &= m - 1) {
+			const Rows& c(_col[LowBit(m)]);
+			for (unsigned int w(0); w < WORDS; ++w) { _conflict[k].w[w] |= c.w[w]; }
+		}
+	}
+	Level root = {};
+	for (size_t k(0); k < _mask.size(); ++k) { root.live.w[k / 64] |= Mask(1) << k % 64; }
+	_level.assign(1, root);
+	_pick.clear();
+	_enter = true;
+	_leave = false;
+}
+
+bool Endgame::Next()
+{
+	if (_leave) { // continue after the stop returned last time
+		_leave = false;
+		Pop();
+	}
+	while (!_level.empty()) {
+		if (_enter) {
+			_enter = false;
+			if (Examine()) {
+				_leave = true;
+				return true;
+			}
+		}
+		if (_stop && _stop->load(memory_order_relaxed)) { Pop(); continue; } // unwind
+		Level& l(_level.back());
+		unsigned int w(0);
+		for (; w < WORDS && !l.todo.w[w]; ++w) {}
+		if (WORDS == w) { Pop(); continue; } // all rows of the column tried, or none to try
+		const size_t x(64 * w + LowBit(l.todo.w[w]));
+		l.todo.w[w] &= l.todo.w[w] - 1;
+		Level child;
+		for (unsigned int v(0); v < WORDS; ++v) { child.live.w[v] = l.live.w[v] & ~_conflict[x].w[v]; }
+		child.used = l.used | _mask[x];
+		_pick.push_back(_id[x]);
+		_level.push_back(child);
+		_enter = true;
+	}
+	return false;
+}
+
+bool Endgame::Examine()
+{
+	Level& l(_level.back());
+	l.todo = Rows();
+	const Mask need(_primary & ~l.used);
+	if (!need) { // all primary columns are covered
+		_leaf = 1;
+		return true;
+	}
+	// minimize search space by selecting the most constrained column
+	unsigned int best(0), least(ROWS + 1);
+	for (Mask m(need); m; m &= m - 1) {
+		const unsigned int b(LowBit(m));
+		unsigned int n(0);
+		for (unsigned int w(0); w < WORDS; ++w) { n += Ones(_col[b].w[w] & l.live.w[w]); }
+		if (n < least) {
+			best = b;
+			least = n;
+			if (!n) { return false; } // no way to cover a column, nothing to try
+		}
+	}
+	if (_bulk && !(need & (need - 1))) { // counting, one primary column left: each of its rows completes a solution
+		_leaf = least;
+		return true;
+	}
+	for (unsigned int w(0); w < WORDS; ++w) { l.todo.w[w] = _col[best].w[w] & l.live.w[w]; }
+	return false;
+}
+
+void Endgame::Pop()
+{
+	_level.pop_back();
+	if (!_pick.empty()) { _pick.pop_back(); } // the root level took no row
+}
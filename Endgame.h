@@ -0,0 +1,63 @@
+// bitmask endgame: finish a small residual exact cover problem with word-parallel row sets
+// Bill Ola Rasmussen
+#pragma once
+
+#include "Solver.h"
+#include <vector>
+#include <cstdint>
+#include <atomic>
+
+// Near the leaves only a few columns and rows are still in play, yet a linked
+// solver keeps paying for every cover and uncover. There a solver copies the
+// residual problem into an Endgame and lets it finish the subtree. Columns
+// are bits of a Mask, the rows still in play are a set of ROWS bits: a
+// column's size is a popcount of its rows in the set, taking a row removes
+// all rows it conflicts with in one AND per word, and nothing needs undoing,
+// each level keeps its own set. The search suspends at each solution the way
+// DLX2::Resume does, so callback and pull based solvers can both use it. The
+// solver's own structure is not touched.
+//
+// Use: Clear, Map the open primary columns into a mask, Map the columns of
+// each row and Add it, Mark its nodes so it is added once, Start, then Next
+// until it returns false. Map fails when the open columns do not fit in BITS,
+// Add when there are more than ROWS rows.
+class Endgame {
+public:
+	typedef std::uint64_t Mask;
+	static const unsigned int BITS = 64; // columns
+	static const unsigned int WORDS = 2;
+	static const unsigned int ROWS = 64 * WORDS;
+	void Clear(const std::size_t columns, const std::size_t nodes); // forget rows, column bits and marks, solver column and node numbers are below these
+	void Mark(const std::size_t node) { _seen[node] = _pass; } // the solver's nodes of rows already added
+	bool Marked(const std::size_t node) const { return _pass == _seen[node]; }
+	bool Map(const std::size_t col, Mask& m); // add the column's bit to m, a new column gets the next free bit, false if none is left
+	bool Add(const Mask m, const std::size_t id); // id: the solver's handle for the row, false if no room is left
+	void Start(const Mask primary, const bool bulk, const std::atomic<bool>* stop); // bulk: counting, stop one level early
+	bool Next(); // search to the next solution, false when done
+	Solver::Count Leaf() const { return _leaf; } // solutions at this stop: 1, or the rows of the last column when bulk
+	const std::vector<std::size_t>& Picks() const { return _pick; } // ids of the rows taken, in search order
+private:
+	struct Rows { Mask w[WORDS]; }; // set of rows: row k is bit k%64 of word k/64
+	struct Level {
+		Rows live, todo; // rows still in play, rows of the level's column not tried yet
+		Mask used; // columns covered by the rows taken above
+	};
+	std::vector<Mask> _mask; // columns of each row
+	std::vector<std::size_t> _id;
+	std::vector<int> _bit; // bit of each solver column, -1 if it has none
+	std::vector<std::size_t> _mapped; // columns holding a bit, in bit order
+	std::vector<unsigned long long> _seen; // stamps: node marked since the last Clear
+	unsigned long long _pass = 0;
+	Rows _col[BITS]; // rows of each column
+	std::vector<Rows> _conflict; // rows sharing a column with each row, itself included
+	std::vector<Level> _level;
+	std::vector<std::size_t> _pick;
+	Mask _primary = 0;
+	bool _bulk = false;
+	bool _enter = false; // top level not examined yet
+	bool _leave = false; // top level was a stop, leave it before going on
+	const std::atomic<bool>* _stop = nullptr;
+	Solver::Count _leaf = 0;
+	bool Examine(); // choose the top level's column, true at a solution
+	void Pop();
+};
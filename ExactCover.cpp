@@ -0,0 +1,297 @@
+// C interface to the solvers, built as libexactcover.so
+// Bill Ola Rasmussen
+
+#include "ExactCover.h"
+#include "Solvers.h"
+#include "Watchdog.h"
+#include "Endgame.h"
+#include <iostream>
+#include <memory>
+#include <limits>
+#include <stdexcept>
+using namespace std;
+
+namespace {
+
+Solver::Propagate propagateValue(const string& value)
+{
+	if ("off" == value) { return Solver::Propagate::Off; }
+	if ("forced" == value) { return Solver::Propagate::Forced; }
+	if ("rows" == value) { return Solver::Propagate::Rows; }
+	throw(runtime_error("unknown propagate mode: " + value));
+}
+
+Solver::Order orderValue(const string& value)
+{
+	if ("input" == value) { return Solver::Order::Input; }
+	if ("eliminate" == value) { return Solver::Order::Eliminate; }
+	if ("learned" == value) { return Solver::Order::Learned; }
+	throw(runtime_error("unknown row order: " + value));
+}
+
+unsigned long long number(const string& name, const string& value)
+{
+	size_t end(0);
+	const unsigned long long n(value.empty() || '-' == value[0] ? 0 : stoull(value, &end));
+	if (value.empty() || end != value.size()) { throw(runtime_error("bad " + name + ": " + value)); }
+	return n;
+}
+
+} // namespace
+
+struct ec_problem {
+	typedef ProblemMatrix::TI TI;
+	const TI pc, sc;
+	ProblemMatrix::Offsets rowStart; // rows added since the matrix was built
+	ProblemMatrix::Indices col;
+	vector<size_t> seen; // last row using each column, catches repeats before the matrix does
+	unique_ptr<ProblemMatrix> pm; // built at a solve, holds all rows then
+	unique_ptr<Solver> solver; // built from pm, reused by later solves
+	string solverName = "dix";
+	unsigned int indexBits = 0;
+	Solver::Propagate propagate = Solver::Propagate::Off;
+	Solver::Order order = Solver::Order::Input;
+	unsigned int endgame = 0;
+	unsigned int split = 0;
+	unsigned long long limit = 0;
+	double seconds = 0;
+	bool keep = true;
+	string error;
+	Solver::Count found = 0;
+	string foundText = "0";
+	const char* status = "complete";
+	vector<int32_t> kept; // rows of kept solutions, back to back
+	vector<size_t> keptStart; // start of each kept solution in kept, plus end
+	ostream quiet; // no buffer: drops the solvers' progress lines, cout belongs to the host program
+
+	ec_problem(const TI p, const TI s) :pc(p), sc(s), rowStart(1, 0), seen(p + s, numeric_limits<size_t>::max()), keptStart(1, 0), quiet(nullptr) {}
+	size_t Rows() const { return (pm ? pm->Rows() : 0) + rowStart.size() - 1; }
+	void AddRow(const int32_t* c, const size_t n)
+	{
+		if (!n) { throw(runtime_error("empty row")); }
+		const size_t r(Rows());
+		if (r >= numeric_limits<TI>::max() - 1) { throw(runtime_error("too many rows")); }
+		for (size_t i(0); i < n; ++i) { // a failed row leaves its marks and nodes to AddRows to take back
+			if (c[i] < 0 || TI(c[i]) >= pc + sc) { throw(runtime_error("column index out of range in row " + to_string(r))); }
+			if (r == seen[c[i]]) { throw(runtime_error("column repeated in row " + to_string(r))); }
+			seen[c[i]] = r;
+			col.push_back(TI(c[i]));
+		}
+		rowStart.push_back(col.size());
+	}
+	template<class Row> void AddRows(const size_t count, Row row) // all rows or none
+	{
+		if (!count) { return; }
+		Unbuild();
+		const size_t rows(rowStart.size()), nodes(col.size());
+		try {
+			for (size_t r(0); r < count; ++r) { row(r); }
+		}
+		catch (exception const&) {
+			for (size_t i(nodes); i < col.size(); ++i) { seen[col[i]] = numeric_limits<size_t>::max(); }
+			rowStart.resize(rows);
+			col.resize(nodes);
+			throw;
+		}
+	}
+	void Unbuild() // take the rows back from the matrix, more are coming
+	{
+		if (!pm) { return; }
+		ProblemMatrix::Offsets start(1, 0);
+		ProblemMatrix::Indices c;
+		c.reserve(pm->Nodes() + col.size());
+		for (TI r(0); r < pm->Rows(); ++r) {
+			c.insert(c.end(), pm->RowBegin(r), pm->RowEnd(r));
+			start.push_back(c.size());
+		}
+		for (size_t r(1); r < rowStart.size(); ++r) { start.push_back(rowStart[r] + pm->Nodes()); }
+		c.insert(c.end(), col.begin(), col.end());
+		rowStart.swap(start);
+		col.swap(c);
+		solver.reset();
+		pm.reset();
+	}
+	void Build() // rows were checked when added, so the matrix takes them as they are
+	{
+		if (!pm) {
+			pm.reset(new ProblemMatrix(pc, sc, move(rowStart), move(col)));
+			rowStart.assign(1, 0);
+			col.clear();
+		}
+		if (!solver) { solver.reset(Solvers().at(solverName)(*pm, indexBits, quiet)); }
+	}
+	template<class F> int Call(F f) // exceptions end at the C boundary
+	{
+		try {
+			f();
+			error.clear();
+			return 0;
+		}
+		catch (exception const& e) {
+			error = e.what();
+			return -1;
+		}
+	}
+};
+
+ec_problem* ec_create(int32_t primary, int32_t secondary)
+{
+	if (primary < 0 || secondary < 0 || !(primary + secondary)) { return nullptr; }
+	try { return new ec_problem(primary, secondary); }
+	catch (exception const&) { return nullptr; }
+}
+
+void ec_destroy(ec_problem* p) { delete p; }
+
+const char* ec_error(const ec_problem* p) { return p->error.c_str(); }
+
+int ec_add_rows(ec_problem* p, const int32_t* cols, size_t size, const int32_t* lengths, size_t count)
+{
+	return p->Call([&]
+	{
+		size_t total(0);
+		for (size_t r(0); r < count; ++r) {
+			if (lengths[r] < 0) { throw(runtime_error("negative row length")); }
+			total += lengths[r];
+		}
+		if (total != size) { throw(runtime_error("row lengths do not add up to the column count given")); }
+		p->AddRows(count, [&](const size_t r)
+		{
+			p->AddRow(cols, lengths[r]);
+			cols += lengths[r];
+		});
+	});
+}
+
+int ec_add_rows_fixed(ec_problem* p, const int32_t* cols, size_t width, size_t count)
+{
+	return p->Call([&]
+	{
+		p->AddRows(count, [&](const size_t r) { p->AddRow(cols + r * width, width); });
+	});
+}
+
+size_t ec_rows(const ec_problem* p) { return p->Rows(); }
+
+int ec_set(ec_problem* p, const char* name, const char* value)
+{
+	return p->Call([&]
+	{
+		const string n(name), v(value);
+		if ("solver" == n) {
+			if (!Solvers().count(v)) { throw(runtime_error("unknown solver: " + v)); }
+			if (Solver::Propagate::Off != p->propagate && "dlx2" != v && "dix" != v) { throw(runtime_error("propagation is for dlx2 and dix only, set propagate off first")); }
+			if (p->endgame && "dlx2" != v && "dix" != v) { throw(runtime_error("endgame is for dlx2 and dix only, set endgame 0 first")); }
+			if (Solver::Order::Input != p->order && "dlx2" != v) { throw(runtime_error("row order is for dlx2 only, set order input first")); }
+			if (p->split && "dix" != v) { throw(runtime_error("split search is for dix only, set split 0 first")); }
+			if (v != p->solverName) { p->solver.reset(); }
+			p->solverName = v;
+		}
+		else if ("index" == n) {
+			const unsigned int bits("auto" == v ? 0 : number(n, v));
+			if (bits != p->indexBits) { p->solver.reset(); }
+			p->indexBits = bits;
+		}
+		else if ("propagate" == n) {
+			const Solver::Propagate propagate(propagateValue(v));
+			if (Solver::Propagate::Off != propagate && "dlx2" != p->solverName && "dix" != p->solverName) { throw(runtime_error("propagation is for dlx2 and dix only")); }
+			p->propagate = propagate;
+		}
+		else if ("order" == n) {
+			const Solver::Order order(orderValue(v));
+			if (Solver::Order::Input != order && "dlx2" != p->solverName) { throw(runtime_error("row order is for dlx2 only")); }
+			p->order = order;
+		}
+		else if ("endgame" == n) {
+			const unsigned int endgame(number(n, v));
+			if (endgame > Endgame::BITS) { throw(runtime_error("endgame column count above " + to_string(Endgame::BITS))); }
+			if ("dlx2" != p->solverName && "dix" != p->solverName) { throw(runtime_error("endgame is for dlx2 and dix only")); }
+			p->endgame = endgame;
+		}
+		else if ("split" == n) {
+			const unsigned int split(number(n, v));
+			if (split && "dix" != p->solverName) { throw(runtime_error("split search is for dix only")); }
+			p->split = split;
+		}
+		else if ("limit" == n) { p->limit = number(n, v); }
+		else if ("seconds" == n) { p->seconds = stod(v); }
+		else if ("keep" == n) { p->keep = number(n, v); }
+		else { throw(runtime_error("unknown setting: " + n)); }
+	});
+}
+
+int ec_solve(ec_problem* p, ec_solution_fn fn, void* user)
+{
+	return p->Call([&]
+	{
+		p->Build();
+		Solver& s(*p->solver);
+		s.propagate = p->propagate;
+		s.order = p->order;
+		s.endgame = p->endgame;
+		s.split = p->split;
+		atomic<bool> stop(false);
+		s.stop = &stop;
+		p->kept.clear();
+		p->keptStart.assign(1, 0);
+		p->status = "complete";
+		bool limited(false), stopped(false);
+		Solver::Count count(0);
+
+		Solver::Show show;
+		vector<int32_t> rows;
+		unsigned long long shown(0);
+		if (fn || p->keep) {
+			show = [&](const Solver::Soln& soln)
+			{
+				if ((p->limit && shown >= p->limit) || stopped) { return; } // found on the way out
+				++shown;
+				if (!fn) {
+					p->kept.insert(p->kept.end(), soln.begin(), soln.end());
+					p->keptStart.push_back(p->kept.size());
+				}
+				else {
+					rows.assign(soln.begin(), soln.end());
+					if (fn(user, rows.data(), rows.size())) { stopped = true; stop = true; }
+				}
+			};
+		}
+		auto callBack([&](const Solver::Event e)
+		{
+			if (Solver::Event::Soln != e) { return; }
+			count = s.found; // may grow by more than one when counting in bulk
+			if (p->limit && count >= p->limit) { count = p->limit; limited = true; stop = true; }
+		});
+		try {
+			unique_ptr<Watchdog> dog(p->seconds > 0 ? new Watchdog(stop, p->seconds) : nullptr);
+			s.Solve(show, callBack);
+		}
+		catch (exception const&) {
+			p->solver.reset(); // structure left mid search
+			throw;
+		}
+		s.stop = nullptr; // the search unwinds cleanly when stopped, the structure is reused
+		if (!limited) { count = s.found; }
+		p->found = count;
+		p->foundText = ToString(count);
+		p->status = limited ? "limit" : stopped ? "stopped" : stop ? "timeout" : "complete";
+	});
+}
+
+uint64_t ec_found(const ec_problem* p)
+{
+	return p->found > numeric_limits<uint64_t>::max() ? numeric_limits<uint64_t>::max() : uint64_t(p->found);
+}
+
+const char* ec_found_text(const ec_problem* p) { return p->foundText.c_str(); }
+
+const char* ec_status(const ec_problem* p) { return p->status; }
+
+size_t ec_solutions(const ec_problem* p) { return p->keptStart.size() - 1; }
+
+const int32_t* ec_solution(const ec_problem* p, size_t i, size_t* count)
+{
+	if (i + 1 >= p->keptStart.size()) { return nullptr; }
+	*count = p->keptStart[i + 1] - p->keptStart[i];
+	return p->kept.data() + p->keptStart[i];
+}
@@ -0,0 +1,70 @@
+// C interface to the solvers, built as libexactcover.so
+// Bill Ola Rasmussen
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// A problem takes its rows from contiguous 32 bit integer buffers, column
+// numbers as in the text input: primary columns first, then secondary ones,
+// 0 based. The buffers are read during the call only. The problem is built
+// into a solver structure at the first solve and the structure is reused by
+// later solves until rows are added or the solver or index changes.
+//
+// Calls returning int give 0 on success and -1 on failure, then ec_error
+// has the message. Rows are checked as they are added, a failed call adds
+// none of its rows. One problem must not be used by two threads at once,
+// different problems may. The library writes nothing to stdout, the
+// solvers' progress lines are dropped.
+//
+// Settings, by name, values as text like the command line options:
+//	solver		dlx, dlx2, dix, acx, dcx (default dix)
+//	index		auto, 16, 32, 64: index width of dix, acx and dcx
+//	propagate	off, forced, rows: dlx2 and dix
+//	order		input, eliminate, learned: dlx2 row order, see Solver.h
+//	endgame		0 to 64: dlx2 and dix, 0 off (default)
+//	split		dix: every this many levels solve independent parts of the
+//				open columns apart, 0 never (default), see Solver.h
+//	limit		end the search after this many solutions, 0 no limit (default)
+//	seconds		end the search after this time, 0 no limit (default)
+//	keep		1: without a callback keep the solution rows for
+//				ec_solution (default), 0: only count, in bulk where the
+//				solver can
+// A solver setting other than its default fails for a solver that does not
+// use it, as does changing to such a solver while it is set.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ec_problem ec_problem;
+
+// one solution: count 0 based row numbers in order of addition, valid during
+// the call only; return nonzero to end the search
+typedef int (*ec_solution_fn)(void* user, const int32_t* rows, size_t count);
+
+ec_problem* ec_create(int32_t primary, int32_t secondary); // NULL on bad counts
+void ec_destroy(ec_problem* p);
+const char* ec_error(const ec_problem* p); // message of the last failure, "" if none
+
+// count rows of lengths[i] columns each, back to back in cols of size entries
+int ec_add_rows(ec_problem* p, const int32_t* cols, size_t size, const int32_t* lengths, size_t count);
+// count rows of width columns each, back to back in cols
+int ec_add_rows_fixed(ec_problem* p, const int32_t* cols, size_t width, size_t count);
+size_t ec_rows(const ec_problem* p);
+
+int ec_set(ec_problem* p, const char* name, const char* value);
+
+// search, each solution goes to fn when given
+int ec_solve(ec_problem* p, ec_solution_fn fn, void* user);
+
+// results of the last solve
+uint64_t ec_found(const ec_problem* p); // solution count, saturates
+const char* ec_found_text(const ec_problem* p); // exact solution count in decimal
+const char* ec_status(const ec_problem* p); // complete, limit, timeout or stopped by the callback
+size_t ec_solutions(const ec_problem* p); // kept solutions
+const int32_t* ec_solution(const ec_problem* p, size_t i, size_t* count); // rows of kept solution i, NULL if out of range
+
+#ifdef __cplusplus
+}
+#endif
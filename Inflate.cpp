@@ -0,0 +1,214 @@
+// input stream buffer that undoes gzip or zstd compression, detected from the first bytes
+// Bill Ola Rasmussen
+
+#include "Inflate.h"
+#include <stdexcept>
+#include <string>
+#include <cstring>
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+using namespace std;
+
+namespace {
+
+const size_t BUFFERS(3); // one with the reader, one being filled, one ready
+const size_t NONE(BUFFERS);
+const size_t CHUNK(1 << 20); // compressed bytes per read from the source
+
+struct Quit {}; // thrown in the decoder thread when the reader is gone
+
+} // namespace
+
+const size_t InflateBuf::BLOCK;
+
+InflateBuf::InflateBuf(streambuf* source) : _source(source), _format(Format::Plain), _head(4), _reading(NONE), _writing(NONE)
+{
+	_head.resize(_source->sgetn(_head.data(), _head.size()));
+	const unsigned char gzip[] = { 0x1f, 0x8b }, zstd[] = { 0x28, 0xb5, 0x2f, 0xfd };
+	if (_head.size() >= sizeof(gzip) && !memcmp(_head.data(), gzip, sizeof(gzip))) { _format = Format::Gzip; }
+	if (_head.size() >= sizeof(zstd) && !memcmp(_head.data(), zstd, sizeof(zstd))) { _format = Format::Zstd; }
+#ifndef HAVE_ZSTD
+	if (Format::Zstd == _format) { throw(runtime_error("zstd input needs a build with zstd support: make ZSTD=1")); }
+#endif
+	if (Format::Plain == _format) { // read on the caller's thread, straight into one buffer
+		_buf.emplace_back(BLOCK);
+		return;
+	}
+	_buf.resize(BUFFERS, vector<char>(BLOCK));
+	for (size_t i(0); i < BUFFERS; ++i) { _free.push_back(i); }
+	_decoder = thread(&InflateBuf::Decode, this);
+}
+
+InflateBuf::~InflateBuf()
+{
+	if (!_decoder.joinable()) { return; }
+	{
+		lock_guard<mutex> lock(_lock);
+		_quit = true;
+	}
+	_changed.notify_all();
+	_decoder.join();
+}
+
+const char* InflateBuf::Name() const
+{
+	switch (_format) {
+	case Format::Gzip: return "gzip";
+	case Format::Zstd: return "zstd";
+	default: return "plain";
+	}
+}
+
+InflateBuf::int_type InflateBuf::underflow()
+{
+	if (gptr() < egptr()) { return traits_type::to_int_type(*gptr()); }
+	if (Format::Plain == _format) {
+		if (_headUsed < _head.size()) { // detection bytes first
+			_headUsed = _head.size();
+			setg(_head.data(), _head.data(), _head.data() + _head.size());
+			return traits_type::to_int_type(*gptr());
+		}
+		char* const p(_buf[0].data());
+		const streamsize n(_source->sgetn(p, BLOCK));
+		if (n <= 0) { return traits_type::eof(); }
+		setg(p, p, p + n);
+		return traits_type::to_int_type(*gptr());
+	}
+	unique_lock<mutex> lock(_lock);
+	if (NONE != _reading) { // give the consumed buffer back to the decoder
+		_free.push_back(_reading);
+		_reading = NONE;
+		_changed.notify_all();
+	}
+	for (;;) {
+		_changed.wait(lock, [this] { return !_full.empty() || _done; });
+		if (_full.empty()) { // decoded buffers are passed on before a decoding error
+			if (_error) { rethrow_exception(_error); }
+			return traits_type::eof();
+		}
+		const auto full(_full.front());
+		_full.pop_front();
+		if (!full.second) { // the last buffer may be empty
+			_free.push_back(full.first);
+			continue;
+		}
+		_reading = full.first;
+		char* const p(_buf[_reading].data());
+		setg(p, p, p + full.second);
+		return traits_type::to_int_type(*gptr());
+	}
+}
+
+// ---------- decoder thread ----------
+
+size_t InflateBuf::Read(char* p, const size_t n)
+{
+	size_t got(0);
+	for (; _headUsed < _head.size() && got < n; ++got) { p[got] = _head[_headUsed++]; }
+	const streamsize more(_source->sgetn(p + got, n - got));
+	return got + (more > 0 ? size_t(more) : 0);
+}
+
+char* InflateBuf::Acquire()
+{
+	unique_lock<mutex> lock(_lock);
+	_changed.wait(lock, [this] { return !_free.empty() || _quit; });
+	if (_quit) { throw(Quit()); }
+	_writing = _free.back();
+	_free.pop_back();
+	return _buf[_writing].data();
+}
+
+void InflateBuf::Deliver(const size_t n)
+{
+	{
+		lock_guard<mutex> lock(_lock);
+		_full.emplace_back(_writing, n);
+		_writing = NONE;
+	}
+	_changed.notify_all();
+}
+
+void InflateBuf::Decode()
+{
+	exception_ptr error;
+	try {
+		if (Format::Gzip == _format) { Gunzip(); }
+		else { Unzstd(); }
+	}
+	catch (const Quit&) {}
+	catch (...) { error = current_exception(); }
+	{
+		lock_guard<mutex> lock(_lock);
+		_error = error;
+		_done = true;
+	}
+	_changed.notify_all();
+}
+
+void InflateBuf::Gunzip()
+{
+	z_stream z;
+	memset(&z, 0, sizeof(z));
+	if (Z_OK != inflateInit2(&z, 16 + MAX_WBITS)) { throw(runtime_error("gzip input: zlib initialization failed")); }
+	struct End { z_stream& z; ~End() { inflateEnd(&z); } } end{ z };
+	vector<char> in(CHUNK);
+	z.next_out = reinterpret_cast<Bytef*>(Acquire());
+	z.avail_out = BLOCK;
+	bool member(false); // inside a gzip member, its end not seen yet
+	for (;;) {
+		if (!z.avail_in) {
+			z.avail_in = uInt(Read(in.data(), in.size()));
+			z.next_in = reinterpret_cast<Bytef*>(in.data());
+			if (!z.avail_in) { break; }
+		}
+		member = true;
+		const int rc(inflate(&z, Z_NO_FLUSH));
+		if (Z_STREAM_END == rc) { // another member may follow, as concatenated .gz files or pigz output have
+			member = false;
+			inflateReset(&z);
+		}
+		else if (Z_OK != rc && Z_BUF_ERROR != rc) { throw(runtime_error(string("gzip input: ") + (z.msg ? z.msg : "corrupt data"))); }
+		if (!z.avail_out) {
+			Deliver(BLOCK);
+			z.next_out = reinterpret_cast<Bytef*>(Acquire());
+			z.avail_out = BLOCK;
+		}
+	}
+	if (member) { throw(runtime_error("gzip input: unexpected end of data")); }
+	Deliver(BLOCK - z.avail_out);
+}
+
+void InflateBuf::Unzstd()
+{
+#ifdef HAVE_ZSTD
+	ZSTD_DStream* const d(ZSTD_createDStream());
+	if (!d) { throw(runtime_error("zstd input: out of memory")); }
+	struct Release { ZSTD_DStream* d; ~Release() { ZSTD_freeDStream(d); } } release{ d };
+	ZSTD_initDStream(d);
+	vector<char> in(ZSTD_DStreamInSize());
+	ZSTD_inBuffer src = { in.data(), 0, 0 };
+	ZSTD_outBuffer dst = { Acquire(), BLOCK, 0 };
+	size_t left(0); // nonzero: inside a frame
+	bool end(false), full(false); // input over, the last call filled its output
+	for (;;) {
+		if (src.pos == src.size && !end) {
+			src.size = Read(in.data(), in.size());
+			src.pos = 0;
+			end = !src.size;
+		}
+		if (end && (!full || !left)) { break; } // a call stopped for want of space may hold output of the last block
+		left = ZSTD_decompressStream(d, &dst, &src); // continues into the next frame by itself
+		if (ZSTD_isError(left)) { throw(runtime_error(string("zstd input: ") + ZSTD_getErrorName(left))); }
+		full = dst.pos == dst.size;
+		if (full) {
+			Deliver(BLOCK);
+			dst = { Acquire(), BLOCK, 0 };
+		}
+	}
+	if (left) { throw(runtime_error("zstd input: unexpected end of data")); }
+	Deliver(dst.pos);
+#endif
+}
@@ -0,0 +1,57 @@
+// input stream buffer that undoes gzip or zstd compression, detected from the first bytes
+// Bill Ola Rasmussen
+#pragma once
+
+#include <streambuf>
+#include <vector>
+#include <deque>
+#include <utility>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+// Wraps the stream buffer of an input file or of std::cin and hands the
+// reader plain text. The magic bytes at the start pick the format: gzip
+// (1f 8b, concatenated members allowed) is inflated with zlib, zstd (28 b5
+// 2f fd) with libzstd when built with ZSTD=1, anything else passes through
+// unchanged. Compressed input is decoded on a thread of its own into BLOCK
+// sized buffers, so decoding the next buffer overlaps parsing this one.
+// Decoding errors are thrown from underflow; set badbit in the exceptions
+// mask of the reading istream to receive them instead of a failed stream.
+class InflateBuf : public std::streambuf {
+public:
+	enum class Format : char { Plain, Gzip, Zstd };
+	static const std::size_t BLOCK = 1 << 22; // bytes per buffer handed to the reader
+	explicit InflateBuf(std::streambuf* source);
+	~InflateBuf();
+	InflateBuf& operator=(const InflateBuf&) = delete;
+	InflateBuf(const InflateBuf&) = delete;
+	Format Detected() const { return _format; }
+	const char* Name() const; // of the detected format
+protected:
+	int_type underflow() override;
+private:
+	std::streambuf* _source;
+	Format _format;
+	std::vector<char> _head; // bytes read to detect the format, passed on first
+	std::size_t _headUsed = 0;
+	std::vector<std::vector<char>> _buf;
+	// shared with the decoder thread
+	std::mutex _lock;
+	std::condition_variable _changed;
+	std::deque<std::pair<std::size_t, std::size_t>> _full; // decoded buffers in order: index, byte count
+	std::vector<std::size_t> _free; // buffers the decoder may fill
+	bool _done = false; // decoder finished, _error set if it failed
+	bool _quit = false; // reader gone, decoder stops at the next buffer
+	std::exception_ptr _error;
+	std::size_t _reading; // buffer the reader holds, none before the first
+	std::size_t _writing; // buffer the decoder fills
+	std::thread _decoder;
+	std::size_t Read(char* p, const std::size_t n); // compressed bytes, _head first
+	char* Acquire(); // next buffer to fill, waits for the reader
+	void Deliver(const std::size_t n); // pass the filled buffer on
+	void Decode(); // decoder thread body
+	void Gunzip();
+	void Unzstd();
+};
@@ -0,0 +1,112 @@
+// hardware performance counters around a phase of work
+// Bill Ola Rasmussen
+
+#include "PerfCounters.h"
+using namespace std;
+
+#ifdef __linux__
+
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+namespace {
+
+struct Event { const char* name; uint32_t type; uint64_t config; };
+
+const uint64_t READ_MISS((PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+
+const Event EVENTS[] = {
+	{ "cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+	{ "instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+	{ "L1d-misses", PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | READ_MISS },
+	{ "LLC-misses", PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | READ_MISS },
+	{ "branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+	{ "dTLB-misses", PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | READ_MISS },
+	{ "page-faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS }, // kernel counted, present without a hardware PMU
+};
+
+int Open(const Event& e)
+{
+	perf_event_attr a;
+	memset(&a, 0, sizeof(a));
+	a.size = sizeof(a);
+	a.type = e.type;
+	a.config = e.config;
+	a.disabled = 1;
+	a.inherit = 1; // also threads started later, such as the decompression thread
+	a.exclude_kernel = 1; // allowed at perf_event_paranoid 2
+	a.exclude_hv = 1;
+	a.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+	return static_cast<int>(syscall(__NR_perf_event_open, &a, 0, -1, -1, 0)); // this thread and its later threads, any cpu
+}
+
+} // namespace
+
+PerfCounters::PerfCounters()
+{
+	int err(0);
+	for (const auto& e : EVENTS) {
+		const int fd(Open(e));
+		if (fd < 0) { err = errno; }
+		_counters.push_back({ e.name, fd, 0 });
+	}
+	for (const auto& c : _counters) { if (c.fd >= 0) { return; } }
+	_unavailable = string("perf_event_open: ") + strerror(err)
+		+ (EACCES == err || EPERM == err ? ", see /proc/sys/kernel/perf_event_paranoid" : "")
+		+ (ENOENT == err || EOPNOTSUPP == err ? ", no such counter here (virtual machine?)" : "");
+}
+
+PerfCounters::~PerfCounters()
+{
+	for (const auto& c : _counters) { if (c.fd >= 0) { close(c.fd); } }
+}
+
+void PerfCounters::Start()
+{
+	for (const auto& c : _counters) {
+		if (c.fd < 0) { continue; }
+		ioctl(c.fd, PERF_EVENT_IOC_RESET, 0);
+		ioctl(c.fd, PERF_EVENT_IOC_ENABLE, 0);
+	}
+}
+
+void PerfCounters::Stop()
+{
+	for (auto& c : _counters) {
+		if (c.fd < 0) { continue; }
+		ioctl(c.fd, PERF_EVENT_IOC_DISABLE, 0);
+		uint64_t v[3]; // value, time enabled, time running
+		c.value = 0;
+		if (sizeof(v) != read(c.fd, v, sizeof(v)) || !v[2]) { continue; }
+		c.value = v[2] < v[1] ? static_cast<unsigned long long>(double(v[0]) * v[1] / v[2]) : v[0]; // multiplexed: scale
+	}
+}
+
+#else
+
+PerfCounters::PerfCounters() : _unavailable("hardware counters need Linux perf_event_open") {}
+PerfCounters::~PerfCounters() {}
+void PerfCounters::Start() {}
+void PerfCounters::Stop() {}
+
+#endif
+
+void PerfCounters::Report(ostream& os, const string& phase) const
+{
+	os << phase << " counters:";
+	if (!_unavailable.empty()) {
+		os << " unavailable, " << _unavailable << '\n';
+		return;
+	}
+	for (const auto& c : _counters) {
+		os << ' ' << c.name << ' ';
+		if (c.fd < 0) { os << "n/a"; }
+		else { os << c.value; }
+	}
+	os << '\n';
+}
@@ -0,0 +1,34 @@
+// hardware performance counters around a phase of work
+// Bill Ola Rasmussen
+#pragma once
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+// Linux perf_event_open counters for the calling thread and the threads it
+// starts after construction, such as the decompression thread: cycles,
+// instructions, L1 data and last level cache read misses, branch misses and
+// data TLB read misses, plus page faults, which the kernel counts even without
+// a hardware counter unit. Each counter is opened on its own, so a counter the
+// CPU or kernel does not offer is reported as n/a and the rest still work.
+// Elsewhere, or when perf_event_paranoid forbids it, Report says why the
+// counters are unavailable. Counts are scaled when the kernel multiplexed them.
+
+class PerfCounters {
+	struct Counter {
+		std::string name;
+		int fd;
+		unsigned long long value;
+	};
+	std::vector<Counter> _counters;
+	std::string _unavailable; // reason, empty if at least one counter opened
+public:
+	PerfCounters();
+	~PerfCounters();
+	PerfCounters&operator=(const PerfCounters&) = delete;
+	PerfCounters(const PerfCounters&) = delete;
+	void Start(); // reset and enable
+	void Stop(); // disable and read
+	void Report(std::ostream& os, const std::string& phase) const; // one line of the last Start..Stop
+};
@@ -0,0 +1,282 @@
+// immutable exact cover problem shared by all solvers
+// Bill Ola Rasmussen
+
+#include "ProblemMatrix.h"
+#include <stdexcept>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <limits>
+#include <cstring>
+#include <cstdint>
+#include <cctype>
+using namespace std;
+
+ProblemMatrix::ProblemMatrix(const TI pc, const TI sc, Offsets&& rowStart, Indices&& col, Meta&& meta, Names&& names, Costs&& cost)
+	: _pc(pc), _sc(sc), _rowStart(move(rowStart)), _col(move(col)), _meta(move(meta)), _names(move(names)), _cost(move(cost))
+{
+	if (0 == Cols()) { throw(runtime_error("zero constraint count")); }
+	if (Named() && _names.size() != Cols()) { throw(runtime_error("column name count does not match constraint count")); }
+	if (Cols() < pc) { throw(runtime_error("constraint count out of range")); }
+	if (_rowStart.empty() || _rowStart.front() || _rowStart.back() != _col.size()) {
+		throw(runtime_error("bad row offsets"));
+	}
+	if (_rowStart.size() - 1 >= numeric_limits<TI>::max()) { throw(runtime_error("too many rows")); }
+	if (Weighted() && _cost.size() != Rows()) { throw(runtime_error("row cost count does not match row count")); }
+
+	// validate rows and count nodes per column
+	_colStart.assign(Cols() + 1, 0);
+	Indices seen(Cols(), numeric_limits<TI>::max()); // last row using each column
+	for (TI r(0); r < Rows(); ++r) {
+		if (!RowSize(r)) { throw(runtime_error("empty row")); }
+		for (auto p(RowBegin(r)); p != RowEnd(r); ++p) {
+			if (*p >= Cols()) { throw(runtime_error("column index out of range")); }
+			if (r == seen[*p]) { throw(runtime_error("column repeated in row")); }
+			seen[*p] = r;
+			++_colStart[*p + 1];
+		}
+	}
+
+	// columns: prefix sum of counts, then distribute rows in input order
+	for (TI c(0); c < Cols(); ++c) { _colStart[c + 1] += _colStart[c]; }
+	_row.resize(_col.size());
+	Offsets next(_colStart.begin(), _colStart.end() - 1);
+	for (TI r(0); r < Rows(); ++r) {
+		for (auto p(RowBegin(r)); p != RowEnd(r); ++p) {
+			_row[next[*p]++] = r;
+		}
+	}
+}
+
+ProblemMatrix::TI ProblemMatrix::PrimaryWidth() const
+{
+	TI widest(0);
+	for (TI r(0); r < Rows(); ++r) {
+		TI w(0);
+		for (auto p(RowBegin(r)); p != RowEnd(r); ++p) { w += *p < _pc; }
+		if (w > widest) { widest = w; }
+	}
+	return widest;
+}
+
+unsigned long ProblemMatrix::MetaNumber(const string& key) const
+{
+	const auto it(_meta.find(key));
+	if (_meta.end() == it) { throw(runtime_error("problem metadata missing: " + key)); }
+	size_t end(0);
+	const auto value(stoul(it->second, &end));
+	if (end != it->second.size()) { throw(runtime_error("problem metadata not a number: " + key)); }
+	return value;
+}
+
+namespace {
+
+using TI = ProblemMatrix::TI;
+const TI NONE(numeric_limits<TI>::max());
+
+// row cost token: $ and a whole number
+ProblemMatrix::Cost ReadCost(const string& token)
+{
+	size_t end(0);
+	ProblemMatrix::Cost cost(0);
+	try { cost = stoull(token.substr(1), &end); }
+	catch (const logic_error&) { end = 0; } // not a number, or out of range
+	if ('$' != token[0] || token.size() < 2 || end != token.size() - 1 || !isdigit(token[1])) { throw(runtime_error("bad row cost: " + token)); }
+	return cost;
+}
+
+// costs of the rows read so far, dropped when no row has one
+class RowCosts {
+	ProblemMatrix::Costs _cost;
+	bool _any = false;
+public:
+	void Row(const ProblemMatrix::Cost cost, const bool given) // given: the row has a cost, maybe $0
+	{
+		_cost.push_back(cost);
+		_any = _any || given;
+	}
+	ProblemMatrix::Costs Take() { return _any ? move(_cost) : ProblemMatrix::Costs(); }
+};
+
+// Item names to dense column numbers, in order of first appearance. Open
+// addressing over a power of two table of column numbers, the names stay in
+// one vector, so a lookup hashes the name in place and compares at most a
+// few names, without building a string per item.
+class Interner {
+public:
+	Interner() : _slot(64, NONE) {}
+	TI Find(const char* p, const size_t n) const
+	{
+		for (size_t i(Hash(p, n) & (_slot.size() - 1));; i = (i + 1) & (_slot.size() - 1)) {
+			const TI c(_slot[i]);
+			if (NONE == c || (_names[c].size() == n && !memcmp(_names[c].data(), p, n))) { return c; }
+		}
+	}
+	bool Add(const char* p, const size_t n) // false if already present
+	{
+		if (NONE != Find(p, n)) { return false; }
+		if (2 * (_names.size() + 1) > _slot.size()) { Grow(); } // at most half full, probe runs stay short
+		_names.emplace_back(p, n);
+		Place(TI(_names.size() - 1));
+		return true;
+	}
+	TI Size() const { return TI(_names.size()); }
+	ProblemMatrix::Names Take() { return move(_names); }
+private:
+	vector<TI> _slot; // column number, NONE for an empty slot
+	ProblemMatrix::Names _names;
+	static size_t Hash(const char* p, const size_t n) // FNV-1a
+	{
+		uint64_t h(14695981039346656037ull);
+		for (size_t i(0); i < n; ++i) { h = (h ^ static_cast<unsigned char>(p[i])) * 1099511628211ull; }
+		return size_t(h ^ h >> 32);
+	}
+	void Place(const TI c)
+	{
+		size_t i(Hash(_names[c].data(), _names[c].size()) & (_slot.size() - 1));
+		while (NONE != _slot[i]) { i = (i + 1) & (_slot.size() - 1); }
+		_slot[i] = c;
+	}
+	void Grow()
+	{
+		_slot.assign(2 * _slot.size(), NONE);
+		for (TI c(0); c < Size(); ++c) { Place(c); }
+	}
+};
+
+// Reads lines as named item input. Until the input shows no '[' follows,
+// the lines may be the free text before a numbered problem, so an error is
+// kept rather than thrown, and reading stops there.
+class NamedReader {
+public:
+	void Line(const string& str);
+	ProblemMatrix Finish(ProblemMatrix::Meta&& meta);
+private:
+	Interner _items;
+	TI _pc = 0;
+	bool _header = false; // item line read
+	string _error;
+	ProblemMatrix::Offsets _rowStart = ProblemMatrix::Offsets(1, 0);
+	ProblemMatrix::Indices _col;
+	RowCosts _cost;
+	void Fail(const string& what, const char* p, const size_t n) { _error = what + ": " + string(p, n); }
+};
+
+void NamedReader::Line(const string& str)
+{
+	if (!_error.empty()) { return; }
+	const char* p(str.data());
+	const char* const end(p + str.size());
+	auto space([](const char c) { return ' ' == c || '\t' == c || '\r' == c; });
+	while (p != end && space(*p)) { ++p; }
+	if (p == end || '|' == *p) { return; } // blank line or comment
+	const auto size(_col.size());
+	bool secondary(false);
+	string cost;
+	while (p != end) { // each name
+		const char* const name(p);
+		while (p != end && !space(*p)) { ++p; }
+		const size_t n(p - name);
+		while (p != end && space(*p)) { ++p; }
+		if (memchr(name, ':', n)) { return Fail("item colors are not supported", name, n); }
+		if ('$' == *name) {
+			if (!_header) { return Fail("item name starts with $", name, n); }
+			if (!cost.empty() || p != end) { return Fail("row cost not last in row", name, n); }
+			cost.assign(name, n);
+			continue;
+		}
+		if (!_header) { // item line
+			if (1 == n && '|' == *name) {
+				if (secondary) { return Fail("second | in item line", name, n); }
+				secondary = true;
+				continue;
+			}
+			if (!_items.Add(name, n)) { return Fail("item named twice", name, n); }
+			if (!secondary) { ++_pc; }
+			continue;
+		}
+		const TI c(_items.Find(name, n));
+		if (NONE == c) { return Fail("unknown item in row", name, n); }
+		_col.push_back(c);
+	}
+	if (!_header) {
+		if (!_pc) { return Fail("no primary items in item line", str.data(), str.size()); }
+		_header = true;
+	}
+	else if (_col.size() != size) {
+		_rowStart.push_back(_col.size());
+		if (cost.empty()) { _cost.Row(0, false); }
+		else {
+			try { _cost.Row(ReadCost(cost), true); }
+			catch (const runtime_error& e) { _error = e.what(); }
+		}
+	}
+	else if (!cost.empty()) { Fail("row cost without items", cost.data(), cost.size()); }
+}
+
+ProblemMatrix NamedReader::Finish(ProblemMatrix::Meta&& meta)
+{
+	if (!_error.empty()) { throw(runtime_error("input has no '[' and is not named item input, " + _error)); }
+	if (!_header) { throw(runtime_error("no problem in input")); }
+	const TI sec(_items.Size() - _pc);
+	cout << "named items, primary constraints: " << _pc << ", "
+		<< "secondary constraints: " << sec << '\n';
+	return ProblemMatrix(_pc, sec, move(_rowStart), move(_col), move(meta), _items.Take(), _cost.Take());
+}
+
+} // namespace
+
+ProblemMatrix ReadProblem(istream& is)
+{
+	string str;
+	ProblemMatrix::TI pri, sec;
+	ProblemMatrix::Meta meta;
+	{ // read constraint counts (columns)
+		NamedReader named; // the same lines as named items, in case no '[' follows
+		bool bracket(false);
+		while (getline(is, str))
+		{
+			if (str.length() && '[' == str[0]) { bracket = true; break; }
+			if (0 == str.compare(0, 5, "meta:")) { // key=value pairs
+				stringstream ss(str.substr(5));
+				for (string kv; ss >> kv;) {
+					const auto eq(kv.find('='));
+					if (string::npos == eq || !eq) { throw(runtime_error("bad metadata: " + kv)); }
+					meta[kv.substr(0, eq)] = kv.substr(eq + 1);
+				}
+			}
+			else { named.Line(str); }
+		}
+		if (!bracket) { return named.Finish(move(meta)); }
+		getline(is, str);
+		stringstream ss(str);
+		ss >> pri >> sec;
+		if (ss.fail()) { throw(runtime_error("fail reading constraint counts")); }
+		cout << "primary constraints: " << pri << ", "
+			<< "secondary constraints: " << sec << '\n';
+	}
+	ProblemMatrix::Offsets rowStart(1, 0);
+	ProblemMatrix::Indices col;
+	RowCosts cost;
+	while (is.good()) // read lines (rows)
+	{
+		getline(is, str);
+		if (str.length() && str[0] == ']')
+		{
+			return ProblemMatrix(pri, sec, move(rowStart), move(col), move(meta), ProblemMatrix::Names(), cost.Take());
+		}
+		const auto size(col.size());
+		stringstream ss(str);
+		for (ProblemMatrix::TI c; ss >> c;) { col.push_back(c); } // read numbers (columns)
+		string token;
+		if (!ss.eof()) { ss.clear(); ss >> token; } // not a number: the row cost, if anything
+		const bool costed(!token.empty() && '$' == token[0]);
+		if (costed && ss >> token) { throw(runtime_error("row cost not last in row: " + str)); }
+		if (col.size() != size) { // end of row, blank lines are skipped
+			rowStart.push_back(col.size());
+			cost.Row(costed ? ReadCost(token) : 0, costed);
+		}
+		else if (costed) { throw(runtime_error("row cost without columns: " + str)); }
+	}
+	throw(runtime_error("no closing bracket in input"));
+}
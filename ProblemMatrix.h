@@ -0,0 +1,75 @@
+// immutable exact cover problem shared by all solvers
+// Bill Ola Rasmussen
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <map>
+
+// The input is parsed and validated once into this matrix. Rows are kept
+// in compressed sparse row form (the columns of each row, in input order)
+// and columns in compressed sparse column form (the rows of each column, in
+// input order). Solvers build their own search structure from it in a single
+// pass, so several solvers can be built from one input.
+
+class ProblemMatrix {
+public:
+	using TI = unsigned int; // row and column index type
+	using Offsets = std::vector<std::size_t>;
+	using Indices = std::vector<TI>;
+	using Meta = std::map<std::string, std::string>; // generator metadata, key=value pairs
+	using Names = std::vector<std::string>; // column names, empty for numbered input
+	using Cost = unsigned long long;
+	using Costs = std::vector<Cost>; // row costs, empty when the input gives none
+	ProblemMatrix(const TI pc, const TI sc, Offsets&& rowStart, Indices&& col, Meta&& meta = Meta(), Names&& names = Names(), Costs&& cost = Costs()); // validates, builds columns
+	TI Primary() const { return _pc; } // primary constraint count: cover exactly once
+	TI Secondary() const { return _sc; } // secondary constraint count: cover at most once
+	TI Cols() const { return _pc + _sc; }
+	TI Rows() const { return static_cast<TI>(_rowStart.size() - 1); }
+	std::size_t Nodes() const { return _col.size(); }
+	// columns of row r: [RowBegin(r), RowEnd(r))
+	const TI* RowBegin(const TI r) const { return _col.data() + _rowStart[r]; }
+	const TI* RowEnd(const TI r) const { return _col.data() + _rowStart[r + 1]; }
+	TI RowSize(const TI r) const { return static_cast<TI>(_rowStart[r + 1] - _rowStart[r]); }
+	// rows of column c: [ColBegin(c), ColEnd(c))
+	const TI* ColBegin(const TI c) const { return _row.data() + _colStart[c]; }
+	const TI* ColEnd(const TI c) const { return _row.data() + _colStart[c + 1]; }
+	TI ColSize(const TI c) const { return static_cast<TI>(_colStart[c + 1] - _colStart[c]); }
+	TI PrimaryWidth() const; // most primary columns in any one row
+	bool Named() const { return !_names.empty(); }
+	const std::string& Name(const TI c) const { return _names[c]; } // only when Named
+	bool Weighted() const { return !_cost.empty(); }
+	Cost RowCost(const TI r) const { return Weighted() ? _cost[r] : 0; }
+	const Meta& Metadata() const { return _meta; }
+	unsigned long MetaNumber(const std::string& key) const; // throws if missing or not a number
+private:
+	TI _pc, _sc;
+	Offsets _rowStart; // index into _col of first column of each row, plus end
+	Indices _col; // columns of all rows, back to back
+	Offsets _colStart; // index into _row of first row of each column, plus end
+	Indices _row; // rows of all columns, back to back
+	Meta _meta;
+	Names _names;
+	Costs _cost;
+};
+
+// read problem in text format: any lines, then '[', a line with primary and
+// secondary constraint counts, one line of column numbers per row, then ']'
+// Lines before '[' that start with "meta:" hold key=value metadata from the
+// generator, e.g. "meta: width=10 height=14 piece=5" for pentomino boards.
+// A row may end with its cost, a $ and a whole number, e.g. "3 7 12 $40",
+// rows without one cost nothing; see Solver::cheapest.
+// Input without '[' is read as named items, the DLX1 format of Knuth's
+// programs: lines starting with '|' are comments, the first other line names
+// the primary items, then after a lone '|' the secondary items, and each
+// following line is a row listing item names, e.g.
+//   a b c | x
+//   a x
+//   b c
+// Names are interned into column numbers while reading, so solvers search
+// the same numbered matrix either way; the names are kept for output. Item
+// colors (name:color) are not supported, a row must not start with '[' and
+// an item name not with '$', rows take costs as above.
+ProblemMatrix ReadProblem(std::istream& is);
@@ -0,0 +1,58 @@
+// search pruning from problem geometry
+// Bill Ola Rasmussen
+
+#include "Pruner.h"
+#include <stdexcept>
+#include <vector>
+using namespace std;
+
+namespace {
+
+// flood fill each region of open cells, cell x,y is column x+width*y
+class AreaPruner {
+	unsigned long _w, _h, _piece;
+	vector<unsigned long long> _open, _seen; // stamps: cell open, cell counted in this call
+	vector<unsigned int> _stack;
+	unsigned long long _pass = 0;
+public:
+	explicit AreaPruner(const ProblemMatrix& pm)
+		: _w(pm.MetaNumber("width")), _h(pm.MetaNumber("height")), _piece(pm.MetaNumber("piece"))
+		, _open(_w * _h), _seen(_w * _h)
+	{
+		if (!_piece) { throw(runtime_error("area pruner: piece size zero")); }
+		if (_w * _h != pm.Primary()) { throw(runtime_error("area pruner: board size does not match primary constraints")); }
+	}
+	bool operator()(const vector<unsigned int>& open)
+	{
+		const auto pass(++_pass);
+		for (const auto& c : open) { _open[c] = pass; }
+		for (const auto& c : open) {
+			if (pass == _seen[c]) { continue; } // in a region already counted
+			unsigned long size(0);
+			_seen[c] = pass;
+			_stack.push_back(c);
+			while (!_stack.empty()) {
+				const unsigned int i(_stack.back());
+				_stack.pop_back();
+				++size;
+				const unsigned long x(i % _w), y(i / _w);
+				const unsigned int next[] = { i - 1, i + 1, unsigned(i - _w), unsigned(i + _w) };
+				const bool inside[] = { x > 0, x + 1 < _w, y > 0, y + 1 < _h };
+				for (int k(0); k < 4; ++k) {
+					const auto n(next[k]);
+					if (inside[k] && pass == _open[n] && pass != _seen[n]) { _seen[n] = pass; _stack.push_back(n); }
+				}
+			}
+			if (size % _piece) { return true; } // region can not be tiled
+		}
+		return false;
+	}
+};
+
+} // namespace
+
+Solver::Prune MakePruner(const string& name, const ProblemMatrix& pm)
+{
+	if ("area" == name) { return AreaPruner(pm); }
+	throw(runtime_error("unknown pruner: " + name));
+}
@@ -0,0 +1,18 @@
+// search pruning from problem geometry
+// Bill Ola Rasmussen
+#pragma once
+
+#include "Solver.h"
+#include "ProblemMatrix.h"
+#include <string>
+
+// A pruner sees the primary columns still to cover after each choice and
+// abandons branches that cannot be completed, using knowledge the exact cover
+// matrix does not carry. Its parameters come from the problem metadata
+// written by the generator, see ReadProblem.
+//
+//	area	polyomino boards from CreateYpentominoData.py, needs width, height
+//			and piece metadata: every connected region of uncovered cells
+//			must have a cell count that is a multiple of the piece size
+
+Solver::Prune MakePruner(const std::string& name, const ProblemMatrix& pm);
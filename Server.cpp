@@ -0,0 +1,403 @@
+// long running solver daemon on a Unix domain socket
+// Bill Ola Rasmussen
+
+#include "Server.h"
+#include <stdexcept>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <memory>
+#include <map>
+#include <vector>
+#include <deque>
+#include <list>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+using namespace std;
+
+#ifdef _WIN32
+
+void Serve(const string&, unsigned int, LoadProblem, BuildSolver)
+{
+	throw(runtime_error("serve mode needs Unix domain sockets, not available in this build"));
+}
+
+#else
+
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+// Running: no stop requested yet, the first stop reason wins
+enum class Status : char { Running, Complete, Limit, Timeout, Cancelled };
+
+const char* StatusName(const Status s)
+{
+	switch (s) {
+	case Status::Complete: return "complete";
+	case Status::Limit: return "limit";
+	case Status::Timeout: return "timeout";
+	case Status::Cancelled: return "cancelled";
+	default: return "running";
+	}
+}
+
+struct Job;
+
+struct Connection {
+	const int fd;
+	mutex sendLock; // one line at a time, replies come from reader and worker threads
+	mutex jobsLock;
+	map<string, shared_ptr<Job>> jobs; // active requests by client id
+	explicit Connection(const int f) :fd(f) {}
+	~Connection() { close(fd); }
+	Connection&operator=(const Connection&) = delete;
+	Connection(const Connection&) = delete;
+	void Send(const string& line) // failure means the client is gone, nothing to do
+	{
+		lock_guard<mutex> l(sendLock);
+		for (size_t done(0); done < line.size();) {
+			const auto n(::send(fd, line.data() + done, line.size() - done, MSG_NOSIGNAL));
+			if (n <= 0) { return; }
+			done += n;
+		}
+	}
+};
+
+struct Problem {
+	const ProblemMatrix pm;
+	mutex idleLock;
+	map<string, vector<unique_ptr<Solver>>> idle; // built solver structures not in use, by solver name
+	explicit Problem(ProblemMatrix&& p) :pm(move(p)) {}
+};
+
+struct Job {
+	string id;
+	shared_ptr<Connection> conn;
+	shared_ptr<Problem> problem;
+	string solverName = "dix";
+	Solver::Soln require, forbid;
+	bool show = false; // stream solution rows
+	unsigned long long limit = 0; // solutions, 0: no limit
+	bool timed = false;
+	Clock::time_point deadline;
+	atomic<bool> stop{ false }; // polled by the search
+	atomic<Status> why{ Status::Running };
+	void Stop(const Status s)
+	{
+		Status running(Status::Running);
+		why.compare_exchange_strong(running, s);
+		stop = true;
+	}
+};
+
+Solver::Soln ParseRows(const string& list)
+{
+	string s(list);
+	replace(s.begin(), s.end(), ',', ' ');
+	istringstream in(s);
+	Solver::Soln rows;
+	for (unsigned int r; in >> r;) { rows.emplace_back(r); }
+	if (!in.eof()) { throw(runtime_error("bad row list: " + list)); }
+	return rows;
+}
+
+class Server {
+	LoadProblem _load;
+	BuildSolver _build;
+	mutex _m; // guards the members below
+	condition_variable _work; // queue has jobs or exit
+	condition_variable _gone; // a reader thread ended
+	deque<shared_ptr<Job>> _queue;
+	list<weak_ptr<Job>> _timed; // jobs with a deadline
+	map<string, shared_ptr<Problem>> _problems;
+	list<shared_ptr<Connection>> _conns;
+	unsigned int _readers = 0;
+	bool _exit = false;
+	atomic<bool> _shutdown{ false };
+	void Read(shared_ptr<Connection> c);
+	void Handle(const shared_ptr<Connection>& c, const string& line);
+	void Submit(const shared_ptr<Connection>& c, const string& verb, const string& id, istringstream& in);
+	void Work();
+	string Run(Job& job);
+	void CheckTimeouts();
+public:
+	Server(LoadProblem load, BuildSolver build) :_load(load), _build(build) {}
+	void Serve(const string& socketPath, unsigned int workers);
+};
+
+// ---------- connections ----------
+
+void Server::Read(shared_ptr<Connection> c)
+{
+	string pending;
+	char buf[4096];
+	for (ssize_t n; (n = recv(c->fd, buf, sizeof(buf), 0)) > 0;) {
+		pending.append(buf, n);
+		for (size_t eol; string::npos != (eol = pending.find('\n'));) {
+			Handle(c, pending.substr(0, eol));
+			pending.erase(0, eol + 1);
+		}
+	}
+	{ // client gone: its requests have nobody to report to
+		lock_guard<mutex> l(c->jobsLock);
+		for (auto& j : c->jobs) { j.second->Stop(Status::Cancelled); }
+	}
+	lock_guard<mutex> l(_m);
+	_conns.remove(c);
+	--_readers;
+	_gone.notify_all();
+}
+
+void Server::Handle(const shared_ptr<Connection>& c, const string& line)
+{
+	istringstream in(line);
+	string verb, key("-"); // key: what an error reply refers to
+	if (!(in >> verb) || '#' == verb[0]) { return; }
+	try {
+		if ("load" == verb) {
+			string file;
+			if (!(in >> key >> file)) { key = "-"; throw(runtime_error("usage: load NAME FILE")); }
+			auto p(make_shared<Problem>(_load(file)));
+			{
+				lock_guard<mutex> l(_m);
+				_problems[key] = p; // running requests keep a replaced problem until they finish
+			}
+			c->Send("loaded " + key + ' ' + to_string(p->pm.Rows()) + ' ' + to_string(p->pm.Cols()) + '\n');
+		}
+		else if ("unload" == verb) {
+			if (!(in >> key)) { key = "-"; throw(runtime_error("usage: unload NAME")); }
+			lock_guard<mutex> l(_m);
+			if (!_problems.erase(key)) { throw(runtime_error("unknown problem")); }
+			c->Send("unloaded " + key + '\n');
+		}
+		else if ("count" == verb || "first" == verb) {
+			if (!(in >> key)) { key = "-"; throw(runtime_error("usage: " + verb + " ID NAME ...")); }
+			Submit(c, verb, key, in);
+		}
+		else if ("cancel" == verb) {
+			string id;
+			in >> id;
+			lock_guard<mutex> l(c->jobsLock);
+			const auto j(c->jobs.find(id));
+			if (c->jobs.end() != j) { j->second->Stop(Status::Cancelled); } // else already finished
+		}
+		else if ("shutdown" == verb) { _shutdown = true; }
+		else { throw(runtime_error("unknown request: " + verb)); }
+	}
+	catch (exception const& e) {
+		c->Send("error " + key + ' ' + e.what() + '\n');
+	}
+}
+
+// in: request after the id
+void Server::Submit(const shared_ptr<Connection>& c, const string& verb, const string& id, istringstream& in)
+{
+	auto job(make_shared<Job>());
+	job->id = id;
+	string name;
+	in >> name;
+	{
+		lock_guard<mutex> l(_m);
+		const auto p(_problems.find(name));
+		if (_problems.end() == p) { throw(runtime_error("unknown problem: " + name)); }
+		job->problem = p->second;
+	}
+	if ("first" == verb) {
+		if (!(in >> job->limit) || !job->limit) { throw(runtime_error("usage: first ID NAME N ...")); }
+		job->show = true;
+	}
+	for (string opt; in >> opt;) {
+		const auto eq(opt.find('='));
+		const string k(opt.substr(0, eq)), v(string::npos == eq ? "" : opt.substr(eq + 1));
+		if ("solver" == k) { job->solverName = v; }
+		else if ("limit" == k) {
+			const auto n(stoull(v));
+			if (n && (!job->limit || n < job->limit)) { job->limit = n; }
+		}
+		else if ("time" == k) {
+			job->timed = true;
+			job->deadline = Clock::now() + chrono::duration_cast<Clock::duration>(chrono::duration<double>(stod(v)));
+		}
+		else if ("require" == k) { job->require = ParseRows(v); }
+		else if ("forbid" == k) { job->forbid = ParseRows(v); }
+		else { throw(runtime_error("unknown option: " + opt)); }
+	}
+	job->conn = c;
+	{
+		lock_guard<mutex> l(c->jobsLock);
+		if (!c->jobs.emplace(job->id, job).second) { throw(runtime_error("request id in use")); }
+	}
+	lock_guard<mutex> l(_m);
+	if (job->timed) { _timed.emplace_back(job); }
+	_queue.emplace_back(job);
+	_work.notify_one();
+}
+
+// ---------- workers ----------
+
+void Server::Work()
+{
+	for (;;) {
+		shared_ptr<Job> job;
+		{
+			unique_lock<mutex> l(_m);
+			_work.wait(l, [this] { return _exit || !_queue.empty(); });
+			if (_exit) { return; }
+			job = _queue.front();
+			_queue.pop_front();
+		}
+		const string reply(Run(*job));
+		{ // release the id before replying, the client may reuse it at once
+			lock_guard<mutex> l(job->conn->jobsLock);
+			job->conn->jobs.erase(job->id);
+		}
+		job->conn->Send(reply);
+	}
+}
+
+// returns the final reply
+string Server::Run(Job& job)
+{
+	const auto begin(Clock::now());
+	Solver::Count count(0);
+	try {
+		if (!job.stop) { // cancelled or timed out while queued: skip
+			Problem& p(*job.problem);
+			unique_ptr<Solver> s;
+			{
+				lock_guard<mutex> l(p.idleLock);
+				auto& idle(p.idle[job.solverName]);
+				if (!idle.empty()) { s = move(idle.back()); idle.pop_back(); }
+			}
+			if (!s) { s.reset(_build(p.pm, job.solverName, cout)); }
+			s->stop = &job.stop;
+
+			Solver::Show show;
+			if (job.show) {
+				show = [&job, &count](const Solver::Soln& soln)
+				{
+					if (job.limit && count > job.limit) { return; }
+					ostringstream os;
+					os << "soln " << job.id;
+					for (const auto& r : soln) { os << ' ' << r; }
+					os << '\n';
+					job.conn->Send(os.str());
+				};
+			}
+			const Solver& solver(*s);
+			auto callBack([&job, &count, &solver](const Solver::Event e)
+			{
+				if (Solver::Event::Soln != e) { return; }
+				count = solver.found; // may grow by more than one when counting in bulk
+				if (job.limit && count >= job.limit) { count = job.limit; job.Stop(Status::Limit); }
+			});
+			if (job.require.empty() && job.forbid.empty()) { s->Solve(show, callBack); }
+			else { s->SolveAssuming(job.require, job.forbid, show, callBack); }
+
+			// the search unwinds cleanly when stopped, so the structure can be reused
+			s->stop = nullptr;
+			lock_guard<mutex> l(p.idleLock);
+			p.idle[job.solverName].emplace_back(move(s));
+		}
+		Status running(Status::Running);
+		job.why.compare_exchange_strong(running, Status::Complete);
+		const chrono::duration<double> d(Clock::now() - begin);
+		return "done " + job.id + ' ' + ToString(count) + ' ' + to_string(d.count()) + ' ' + StatusName(job.why) + '\n';
+	}
+	catch (exception const& e) { // solver structure discarded
+		return "error " + job.id + ' ' + e.what() + '\n';
+	}
+}
+
+void Server::CheckTimeouts()
+{
+	const auto now(Clock::now());
+	lock_guard<mutex> l(_m);
+	for (auto i(_timed.begin()); i != _timed.end();) {
+		const auto job(i->lock());
+		if (!job || job->why != Status::Running) { i = _timed.erase(i); continue; }
+		if (now >= job->deadline) { job->Stop(Status::Timeout); i = _timed.erase(i); continue; }
+		++i;
+	}
+}
+
+// ---------- main loop ----------
+
+void Server::Serve(const string& socketPath, unsigned int workers)
+{
+	sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (socketPath.size() >= sizeof(addr.sun_path)) { throw(runtime_error("socket path too long: " + socketPath)); }
+	strcpy(addr.sun_path, socketPath.c_str());
+
+	const int lfd(socket(AF_UNIX, SOCK_STREAM, 0));
+	if (lfd < 0) { throw(runtime_error(string("socket: ") + strerror(errno))); }
+	struct stat st;
+	if (0 == stat(socketPath.c_str(), &st) && S_ISSOCK(st.st_mode)) { unlink(socketPath.c_str()); } // left by an earlier run
+	if (bind(lfd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) || listen(lfd, 16)) {
+		const string err(strerror(errno));
+		close(lfd);
+		throw(runtime_error("unable to listen on " + socketPath + ": " + err));
+	}
+
+	if (!workers) { workers = max(1u, thread::hardware_concurrency()); }
+	cout << "serving on " << socketPath << " with " << workers << " worker(s)\n" << flush;
+	vector<thread> pool;
+	for (unsigned int i(0); i < workers; ++i) { pool.emplace_back(&Server::Work, this); }
+
+	while (!_shutdown) {
+		pollfd p{ lfd, POLLIN, 0 };
+		if (poll(&p, 1, 100) > 0 && (p.revents & POLLIN)) { // wake up regularly to enforce time limits
+			const int fd(accept(lfd, nullptr, nullptr));
+			if (fd >= 0) {
+				auto c(make_shared<Connection>(fd));
+				lock_guard<mutex> l(_m);
+				_conns.emplace_back(c);
+				++_readers;
+				thread(&Server::Read, this, c).detach();
+			}
+		}
+		CheckTimeouts();
+	}
+	close(lfd);
+	unlink(socketPath.c_str());
+
+	{ // stop everything, wake readers blocked on their sockets
+		lock_guard<mutex> l(_m);
+		_exit = true;
+		for (auto& c : _conns) {
+			{
+				lock_guard<mutex> j(c->jobsLock);
+				for (auto& job : c->jobs) { job.second->Stop(Status::Cancelled); }
+			}
+			shutdown(c->fd, SHUT_RDWR);
+		}
+	}
+	_work.notify_all();
+	for (auto& t : pool) { t.join(); }
+	unique_lock<mutex> l(_m);
+	_gone.wait(l, [this] { return !_readers; });
+	cout << "server stopped\n";
+}
+
+} // namespace
+
+void Serve(const string& socketPath, unsigned int workers, LoadProblem load, BuildSolver build)
+{
+	Server(load, build).Serve(socketPath, workers);
+}
+
+#endif
@@ -0,0 +1,35 @@
+// long running solver daemon on a Unix domain socket
+// Bill Ola Rasmussen
+#pragma once
+
+#include "Solver.h"
+#include "ProblemMatrix.h"
+#include <string>
+#include <functional>
+
+// Problems are loaded once and stay resident under a name. Requests run on a
+// pool of worker threads, each with its own solver structure built from the
+// shared problem; idle structures are kept for reuse. Solutions stream back
+// as they are found. Text protocol, one request or reply per line:
+//
+//	load NAME FILE			loaded NAME ROWS COLUMNS
+//	unload NAME				unloaded NAME
+//	count ID NAME [opts]	done ID COUNT SECONDS STATUS
+//	first ID NAME N [opts]	soln ID ROW ROW ... (up to N times), then done ...
+//	cancel ID				no reply, the request ends with done ... cancelled
+//	shutdown				stop the daemon
+//
+//	opts: solver=NAME (default dix) limit=SOLUTIONS time=SECONDS
+//	      require=ROW,ROW,... forbid=ROW,ROW,... (dlx2 and dix)
+//	STATUS: complete, limit, timeout or cancelled
+//	errors: error KEY MESSAGE, KEY: request ID, problem NAME, or - if neither is known
+//
+// Every request except cancel and shutdown gets exactly one final reply:
+// loaded, unloaded, done or error. ID is chosen by the client, unique among
+// its active requests. ROW numbers are 0 based input rows, as in -queries.
+
+using LoadProblem = std::function<ProblemMatrix(const std::string& file)>;
+using BuildSolver = std::function<Solver*(const ProblemMatrix&, const std::string& solverName, std::ostream& out)>;
+
+// serve until a shutdown request, workers: 0 for one per hardware thread
+void Serve(const std::string& socketPath, unsigned int workers, LoadProblem load, BuildSolver build);
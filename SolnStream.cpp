@@ -0,0 +1,154 @@
+// solution output: text and compact binary solution streams
+// Bill Ola Rasmussen
+
+#include "SolnStream.h"
+#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include <zlib.h>
+using namespace std;
+
+static const char MAGIC[] = { 'E','C','S','1' };
+
+void WriteText(ostream& os, const ProblemMatrix& pm, const Solver::Soln& soln)
+{
+	os << "[\n";
+	for (const auto& r : soln) { // each row in solution
+		for (auto p(pm.RowBegin(r)); p != pm.RowEnd(r); ++p) {
+			if (pm.Named()) { os << pm.Name(*p) << " "; }
+			else { os << *p << " "; }
+		}
+		os << "\n";
+	}
+	os << "]\n";
+	if (pm.Weighted()) {
+		ProblemMatrix::Cost cost(0);
+		for (const auto& r : soln) { cost += pm.RowCost(r); }
+		os << "cost: " << cost << '\n';
+	}
+}
+
+// ---------- binary writer ----------
+
+static void PutU32(ostream& os, const uint32_t x)
+{
+	const char b[] = { char(x), char(x >> 8), char(x >> 16), char(x >> 24) };
+	os.write(b, sizeof(b));
+}
+
+SolnWriter::SolnWriter(ostream& os) : _os(os), _closed(false)
+{
+	_os.write(MAGIC, sizeof(MAGIC));
+}
+
+void SolnWriter::Close()
+{
+	_closed = true;
+	Flush();
+	_os.flush();
+	if (!_os) { throw(runtime_error("solution stream write failure")); }
+}
+
+SolnWriter::~SolnWriter()
+{
+	if (_closed) { return; }
+	try { Flush(); _os.flush(); }
+	catch (...) {} // must not throw from a destructor, Close reports errors
+}
+
+void SolnWriter::Varint(unsigned long long x)
+{
+	for (; x >= 0x80; x >>= 7) { _raw += char(x | 0x80); } // 7 bits per byte, high bit: more follows
+	_raw += char(x);
+}
+
+void SolnWriter::Write(const Solver::Soln& soln)
+{
+	size_t keep(0);
+	for (; keep < soln.size() && keep < _prev.size() && soln[keep] == _prev[keep]; ++keep) {}
+	Varint(keep);
+	Varint(soln.size() - keep);
+	for (size_t i(keep); i < soln.size(); ++i) {
+		Varint(soln[i]);
+	}
+	_prev = soln;
+	if (_raw.size() >= BLOCK) { Flush(); }
+}
+
+void SolnWriter::Flush()
+{
+	if (_raw.empty()) { return; }
+	uLongf size(compressBound(_raw.size()));
+	string packed(size, '\0');
+	if (Z_OK != compress2(reinterpret_cast<Bytef*>(&packed[0]), &size,
+		reinterpret_cast<const Bytef*>(_raw.data()), _raw.size(), Z_DEFAULT_COMPRESSION)) {
+		throw(runtime_error("solution block compression failure"));
+	}
+	PutU32(_os, uint32_t(_raw.size()));
+	PutU32(_os, uint32_t(size));
+	_os.write(packed.data(), size);
+	_raw.clear();
+	_prev.clear(); // next block decodes independently
+}
+
+// ---------- binary reader ----------
+
+static bool GetU32(istream& is, uint32_t& x)
+{
+	unsigned char b[4];
+	if (!is.read(reinterpret_cast<char*>(b), sizeof(b))) { return false; }
+	x = b[0] | b[1] << 8 | b[2] << 16 | uint32_t(b[3]) << 24;
+	return true;
+}
+
+SolnReader::SolnReader(istream& is) : _is(is), _pos(0)
+{
+	char magic[sizeof(MAGIC)];
+	if (!_is.read(magic, sizeof(magic)) || !equal(magic, magic + sizeof(magic), MAGIC)) {
+		throw(runtime_error("not a binary solution stream"));
+	}
+}
+
+bool SolnReader::Fill()
+{
+	uint32_t raw, packed;
+	if (!GetU32(_is, raw)) { return false; }
+	if (!GetU32(_is, packed)) { throw(runtime_error("truncated solution block header")); }
+	string in(packed, '\0');
+	if (!_is.read(&in[0], packed)) { throw(runtime_error("truncated solution block")); }
+	_raw.assign(raw, '\0');
+	uLongf size(raw);
+	if (Z_OK != uncompress(reinterpret_cast<Bytef*>(&_raw[0]), &size, reinterpret_cast<const Bytef*>(in.data()), packed) || size != raw) {
+		throw(runtime_error("solution block decompression failure"));
+	}
+	_pos = 0;
+	_prev.clear();
+	return true;
+}
+
+unsigned long long SolnReader::Varint()
+{
+	unsigned long long x(0);
+	for (int shift(0);; shift += 7) {
+		if (_pos >= _raw.size() || shift > 63) { throw(runtime_error("bad varint in solution block")); }
+		const unsigned char b(_raw[_pos++]);
+		x |= (unsigned long long)(b & 0x7f) << shift;
+		if (!(b & 0x80)) { return x; }
+	}
+}
+
+bool SolnReader::Read(Solver::Soln& soln)
+{
+	while (_pos >= _raw.size()) {
+		if (!Fill()) { return false; }
+	}
+	const auto keep(Varint());
+	const auto add(Varint());
+	if (keep > _prev.size()) { throw(runtime_error("bad prefix length in solution block")); }
+	soln.assign(_prev.begin(), _prev.begin() + keep);
+	for (unsigned long long i(0); i < add; ++i) {
+		soln.push_back(static_cast<unsigned int>(Varint()));
+	}
+	_prev = soln;
+	return true;
+}
@@ -0,0 +1,53 @@
+// solution output: text and compact binary solution streams
+// Bill Ola Rasmussen
+#pragma once
+
+#include "Solver.h"
+#include "ProblemMatrix.h"
+#include <ostream>
+#include <istream>
+#include <string>
+
+// text format: '[', one line of column numbers per solution row, ']'
+void WriteText(std::ostream& os, const ProblemMatrix& pm, const Solver::Soln& soln);
+
+// Binary solution stream
+// ----------------------
+// file:	magic "ECS1", then blocks
+// block:	uint32 raw size, uint32 compressed size (little endian), zlib data
+// raw:		one record per solution: varint count of leading rows shared with
+//			the previous solution, varint count of new rows, varint row numbers
+// Consecutive solutions of a depth first search share long prefixes, so
+// usually only the last few rows are written. Each block starts without a
+// previous solution so blocks decode independently.
+
+class SolnWriter {
+	std::ostream& _os;
+	std::string _raw; // current block, not yet compressed
+	Solver::Soln _prev; // previous solution in current block
+	bool _closed;
+	void Varint(unsigned long long x);
+	void Flush();
+public:
+	static const std::size_t BLOCK = 1 << 20; // raw block size target
+	explicit SolnWriter(std::ostream& os);
+	void Write(const Solver::Soln& soln);
+	void Close(); // write last block, throws if the stream failed
+	~SolnWriter(); // if not closed: write last block, errors ignored
+	SolnWriter&operator=(const SolnWriter&) = delete; // no assignment
+	SolnWriter(const SolnWriter&) = delete; // no copy constructor
+};
+
+class SolnReader {
+	std::istream& _is;
+	std::string _raw; // current block, decompressed
+	std::size_t _pos; // read position in _raw
+	Solver::Soln _prev; // previous solution in current block
+	unsigned long long Varint();
+	bool Fill(); // read next block, false at end of stream
+public:
+	explicit SolnReader(std::istream& is); // checks magic
+	bool Read(Solver::Soln& soln); // false at end of stream
+	SolnReader&operator=(const SolnReader&) = delete; // no assignment
+	SolnReader(const SolnReader&) = delete; // no copy constructor
+};
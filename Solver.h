@@ -3,12 +3,68 @@
 #pragma once
 
 #include <functional>
+#include <vector>
+#include <stdexcept>
+#include <atomic>
+#include <string>
+#include <iostream>
+
+// Solvers are constructed from a ProblemMatrix, see ProblemMatrix.h
 
 struct Solver {
 	enum class Event : char {Begin,Soln,End};
-	virtual void Init(const unsigned int pc, const unsigned int sc) = 0; // primary and secondary constraint count
-	virtual void Row(const unsigned int col)=0; // start a new row with a column constraint
-	virtual void Col(const unsigned int col)=0; // insert column constraint in current row
-	virtual void Solve(const bool showSoln, std::function<void(Event)>CallBack)=0; // show solutions, callback for solution events
+	enum class Check : char {Off,Sum,Full}; // structure integrity verification around the search
+	enum class Propagate : char {Off,Forced,Rows}; // after each choice: none, take forced rows and fail on empty columns, also prune rows that would empty a column
+	enum class Order : char {Input,Eliminate,Learned}; // rows of the chosen column tried: in input order, fewest other rows eliminated first, fewest dead ends below them so far first
+	using Soln = std::vector<unsigned int>; // solution: 0 based input row numbers, in search order
+	using Show = std::function<void(const Soln&)>; // receives each solution, empty to not report rows
+#ifdef __SIZEOF_INT128__
+	__extension__ typedef unsigned __int128 Count; // solution count, large boards overflow 64 bits
+#else
+	typedef unsigned long long Count;
+#endif
+	virtual void Solve(Show ShowSoln, std::function<void(Event)>CallBack)=0; // show solutions, callback for solution events
+	// Solve with rows that must be part of every solution and rows that must
+	// not. The structure is restored afterwards, so queries can be repeated on
+	// one built solver. Required rows lead each reported solution.
+	virtual void SolveAssuming(const Soln& /*require*/, const Soln& /*forbid*/, Show /*ShowSoln*/, std::function<void(Event)>/*CallBack*/)
+	{
+		throw(std::runtime_error("solver does not support assumptions"));
+	}
+	virtual std::string FoundText()const; // exact solution count, found may saturate where a solver counts past Count
+	virtual ~Solver(){}
+	Check check=Check::Off; // set before Solve
+	Count found=0; // solutions found by the last Solve, one solver per thread
+	Propagate propagate=Propagate::Off; // set before Solve, used by dlx2 and dix
+	using Prune = std::function<bool(const std::vector<unsigned int>& open)>; // open: 0 based primary columns still to cover, true: abandon branch
+	Prune prune; // optional, set before Solve, called after each choice by dlx2 and dix, see Pruner.h
+	unsigned int cheapest=0; // set before Solve, used by dix: report only this many covers of least total row cost, branch and bound on the input's row costs, 0 all covers
+	Order order=Order::Input; // set before Solve, used by dlx2: changes which solution comes first, not the solutions
+	unsigned int endgame=0; // set before Solve, used by dlx2 and dix: at most this many primary columns open, finish with the bitmask endgame, 0 never, see Endgame.h
+	unsigned int split=0; // set before Solve, used by dix: every this many levels, solve the open columns apart when they fall into parts sharing no rows, 0 never
+	std::ostream* out=&std::cout; // progress lines of Solve, a stream without a buffer drops them, the factories in Solvers.h set it
+	const std::atomic<bool>* stop=nullptr; // optional: when set, the search unwinds early and leaves the structure intact
+	bool Stopped()const{return stop&&stop->load(std::memory_order_relaxed);}
 };
 
+// Event::Soln reports one or more solutions: without a Show, a solver may count
+// the last level in bulk, found has the total.
+
+inline std::string ToString(Solver::Count x) // std::to_string has no 128 bit overload
+{
+	std::string s;
+	do { s.insert(s.begin(), char('0' + unsigned(x % 10))); x /= 10; } while (x);
+	return s;
+}
+
+inline std::string Solver::FoundText()const{return ToString(found);}
+
+// Rolling checksum over the link fields of a solver structure, used for
+// Check::Sum. Costs one pass over the structure before and after the search
+// and no memory, unlike Check::Full which keeps a copy of the structure.
+class CheckSum {
+	unsigned long long _h=14695981039346656037ull; // FNV-1a offset basis
+public:
+	CheckSum&Add(const unsigned long long x){_h=((_h<<7|_h>>57)^x)*1099511628211ull;return *this;} // rotate, mix, FNV prime
+	unsigned long long Value()const{return _h;}
+};
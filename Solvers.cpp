@@ -0,0 +1,59 @@
+// solvers by name, shared by the command line solver, the daemon and the library
+// Bill Ola Rasmussen
+
+#include "Solvers.h"
+#include "dlx.h"
+#include "dlx2.h"
+#include "dix.h"
+#include "acx.h"
+#include "dcx.h"
+#include "axt.h"
+#include "tmx.h"
+#include <iostream>
+#include <limits>
+#include <cstdint>
+using namespace std;
+
+namespace {
+
+// Build solver S with the narrowest index type holding its largest index,
+// or with the requested width in bits. 0 bits: automatic choice.
+template<template<class> class S>
+Solver* makeIndexed(const ProblemMatrix& pm, const unsigned int bits, ostream& out)
+{
+	const size_t need(S<uint64_t>::MaxIndex(pm));
+	if (bits && 16 != bits && 32 != bits && 64 != bits) { throw(runtime_error("unsupported index width: " + to_string(bits))); }
+	const bool fit16(need < numeric_limits<uint16_t>::max()), fit32(need < numeric_limits<uint32_t>::max());
+	if ((16 == bits && !fit16) || (32 == bits && !fit32)) { throw(runtime_error("index width too narrow for problem")); }
+	if (16 == bits || (!bits && fit16)) { out << "index type: 16 bit\n"; return new S<uint16_t>(pm); }
+	if (32 == bits || (!bits && fit32)) { out << "index type: 32 bit\n"; return new S<uint32_t>(pm); }
+	out << "index type: 64 bit\n";
+	return new S<uint64_t>(pm);
+}
+
+template<class F>
+MakeSolver writingTo(F make) // the built solver reports on the stream given
+{
+	return [make](const ProblemMatrix& pm, const unsigned int bits, ostream& out) -> Solver*
+	{
+		Solver* s(make(pm, bits, out));
+		s->out = &out;
+		return s;
+	};
+}
+
+} // namespace
+
+const map<string, MakeSolver>& Solvers()
+{
+	static const map<string, MakeSolver> m{
+		{ "dlx", writingTo([](const ProblemMatrix& pm, unsigned int, ostream&) -> Solver* { return new DLX(pm); }) },
+		{ "dlx2", writingTo([](const ProblemMatrix& pm, unsigned int, ostream&) -> Solver* { return new DLX2(pm); }) },
+		{ "dix", writingTo(makeIndexed<DIX>) },
+		{ "acx", writingTo(makeIndexed<ACX>) },
+		{ "dcx", writingTo(makeIndexed<DCX>) },
+		{ "tmx", writingTo([](const ProblemMatrix& pm, unsigned int, ostream&) -> Solver* { return new TMX(pm); }) }, // counts board tilings only
+		{ "axt", writingTo([](const ProblemMatrix& pm, unsigned int, ostream&) -> Solver* { return new AXT(pm); }) }, // note: in progress...
+	};
+	return m;
+}
@@ -0,0 +1,16 @@
+// solvers by name, shared by the command line solver, the daemon and the library
+// Bill Ola Rasmussen
+#pragma once
+
+#include "Solver.h"
+#include "ProblemMatrix.h"
+#include <string>
+#include <map>
+#include <functional>
+
+// solver factory: build a named solver from a loaded problem
+// indexBits: index width of dix, acx and dcx, 0 for the narrowest that fits
+// out: build and search progress lines, becomes the solver's Solver::out
+using MakeSolver = std::function<Solver*(const ProblemMatrix&, const unsigned int indexBits, std::ostream& out)>;
+
+const std::map<std::string, MakeSolver>& Solvers();
@@ -0,0 +1,49 @@
+// time limit for a search: sets its stop flag once the time has passed
+// Bill Ola Rasmussen
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// A thread waits out the time unless the watchdog is destroyed first, then
+// sets the flag polled by the search, see Solver::stop. Extend moves the
+// deadline later, so time spent outside the search need not count.
+class Watchdog {
+	typedef std::chrono::steady_clock Clock;
+	std::atomic<bool>& _stop;
+	std::mutex _m;
+	std::condition_variable _cv;
+	bool _done = false;
+	Clock::time_point _deadline;
+	std::thread _t;
+	static Clock::duration Span(const double seconds)
+	{
+		return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+	}
+public:
+	Watchdog(std::atomic<bool>& stop, const double seconds) :_stop(stop), _deadline(Clock::now() + Span(seconds)), _t([this]
+	{
+		std::unique_lock<std::mutex> lock(_m);
+		while (!_done && Clock::now() < _deadline) { _cv.wait_until(lock, _deadline); }
+		if (!_done) { _stop = true; }
+	}) {}
+	void Extend(const double seconds)
+	{
+		std::lock_guard<std::mutex> lock(_m);
+		_deadline += Span(seconds);
+	}
+	~Watchdog()
+	{
+		{
+			std::lock_guard<std::mutex> lock(_m);
+			_done = true;
+		}
+		_cv.notify_one();
+		_t.join();
+	}
+	Watchdog& operator=(const Watchdog&) = delete;
+	Watchdog(const Watchdog&) = delete;
+};
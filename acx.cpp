@@ -9,190 +9,203 @@ using namespace std;
 
 // ---------- build data structure from input ----------
 
-void ACX::Init(const unsigned int pc, const unsigned int sc)
+template<class TI>
+ACX<TI>::ACX(const ProblemMatrix& pm) : _pc(pm.Primary())
 {
+	if (MaxIndex(pm) >= numeric_limits<TI>::max()) { throw(runtime_error("too many nodes for index type")); }
 	// primary constraint: cover this exactly once
 	// secondary constraint: cover this at most once
-	if (!pc) { throw(runtime_error("no primary constraints")); }
-	_pc = pc;
-	if (!_start_board.empty()) { throw(runtime_error("board already initialized")); }
-	_start_board.resize(pc + sc, 0); // all cover counts start at zero
-}
-
-void ACX::Row(const unsigned int col)
-{
-	_start_tiles.push_back(Tile()); // start a new tile
-	Col(col);
-}
-
-void ACX::Col(const unsigned int col)
-{
-	if (col >= _start_board.size()) { throw(runtime_error("column index for tile out of board range")); }
-	++_start_board[col]; // increase cover count
-	_start_tiles.back().push_back(col);
-}
-
-void ACX::ShrinkToFit()
-{
-	// call shrink_to_fit() on all vectors
-	_start_board.shrink_to_fit();
-	for (auto& t : _start_tiles) { t.shrink_to_fit(); }
-	_start_tiles.shrink_to_fit();
+	if (!_pc) { throw(runtime_error("no primary constraints")); }
+	_board.resize(pm.Cols()); // cover count of each column is its count of tiles
+	for (TI c(0); c < pm.Cols(); ++c) {
+		_board[c] = pm.ColSize(c);
+	}
+	_cell.reserve(pm.Nodes());
+	_first.reserve(pm.Rows() + 1);
+	for (ProblemMatrix::TI r(0); r < pm.Rows(); ++r) { // tiles in input order
+		_first.push_back(_cell.size());
+		_cell.insert(_cell.end(), pm.RowBegin(r), pm.RowEnd(r));
+	}
+	_first.push_back(_cell.size()); // end marker for last tile
+	_tilesidxs.resize(pm.Rows());
+	for (TI i(0); i < pm.Rows(); ++i) {
+		_tilesidxs[i] = i; // include all tiles in possibility list
+	}
+	_live = pm.Rows();
 }
 
 // ---------- solve exact cover problem ----------
 
-void ACX::Solve(const bool showSoln, std::function<void(Event)> CallBack)
+// A single board and tile index list are modified in place at every search
+// level. Tiles are taken out of play by swapping them past _live, so the
+// removed tiles of each level form a stack at the end of _tilesidxs. Backtracking
+// restores the board for exactly those tiles and moves _live back, the cost of
+// undo is the cost of the change, not the size of the problem.
+
+template<class TI>
+void ACX<TI>::Solve(Show ShowSoln, std::function<void(Event)> CallBack)
 {
-	_show = showSoln;
+	_show = ShowSoln;
 	_notify = CallBack;
-	cout << "ACX::Solve, board size: " << _start_board.size() << ", tiles: " << _start_tiles.size() << "\n";
-	ShrinkToFit(); // vector sizes are now unchanging, so trim extra space
+	const TI tiles(_tilesidxs.size());
+	*out << "ACX::Solve, board size: " << _board.size() << ", tiles: " << tiles << "\n";
+	// save for later integrity check, only as much as the check mode needs
+	const unsigned long long check_sum(Check::Sum == check ? Sum() : 0);
+	const Board check_board(Check::Full == check ? _board : Board());
+
 	TilesIdxs soln;
-	TilesIdxs tilesidxs; // index into _start_tiles
-	for (TI i(0); i < _start_tiles.size(); ++i) {
-		tilesidxs.push_back(i); // include all tiles in possibility list
-	}
+	found = 0;
 	_notify(Event::Begin);
-	Search(soln, _start_board, tilesidxs);
+	Search(soln);
 	_notify(Event::End);
+
+	if (Check::Off != check && _live != tiles) { throw(runtime_error("tile list integrity failure")); }
+	if (Check::Sum == check && check_sum != Sum()) { throw(runtime_error("board checksum failure")); }
+	if (Check::Full == check && check_board != _board) { throw(runtime_error("board integrity failure")); }
+	if (Check::Off != check) { *out << "Board integrity verified.\n"; }
 }
 
-void ACX::Search(TilesIdxs& soln, const Board& board, const TilesIdxs& tilesidxs) const
+template<class TI>
+unsigned long long ACX<TI>::Sum() const
 {
-	const auto col(ChooseColumn(board));
-	if (!board[col]) { return; } // a column could not be covered with remaining tiles, abort this search branch
-	if (numeric_limits<TI>::max() == board[col]) { // all primary constraint board positions are covered
+	CheckSum s;
+	for (const auto& count : _board) { s.Add(count); }
+	return s.Value();
+}
+
+template<class TI>
+void ACX<TI>::Search(TilesIdxs& soln)
+{
+	const auto col(ChooseColumn());
+	if (!_board[col]) { return; } // a column could not be covered with remaining tiles, abort this search branch
+	if (numeric_limits<TI>::max() == _board[col]) { // all primary constraint board positions are covered
+		++found;
 		_notify(Event::Soln);
 		if (_show) { ShowSoln(soln); }
 		return;
 	}
 	// Minimize work by finding least covered column. A set of tile choices covers
 	// this column. Minimize work by removing these choices once instead of each
-	// time through the choice loop.
-	Board boardNC(board); // start with board and subtract
-	TilesIdxs tilesidxsNC(tilesidxs); // start full and remove
-	const auto choices(RemoveTiles(boardNC, tilesidxsNC, col)); // remove tiles covering col, return list of tiles
-
-	for (const auto& tilesidx : choices) {
-		const auto& choice(_start_tiles[tilesidx]);
-		const auto removed(RemoveTiles(boardNC, tilesidxsNC, choice));
-		MarkBoard(boardNC, choice, numeric_limits<TI>::max());
-		// slower:
-		//for (const auto& pos : boardNC) { // early check:
-		//	if (!pos) { continue; } // impossible to cover board after making choice
-		//}
-
-		soln.push_back(tilesidx);
-		Search(soln, boardNC, tilesidxsNC);
+	// time through the choice loop. The choices are then read back from the
+	// removed part of the tile index list.
+	const TI markCol(_live);
+	RemoveColTiles(col);
+	const TI markChoice(_live); // choices are at [markChoice, markCol)
+
+	for (TI i(markChoice); i < markCol; ++i) {
+		const TI choice(_tilesidxs[i]);
+		MarkBoard(choice, numeric_limits<TI>::max());
+		RemoveMarkedTiles();
+
+		soln.push_back(choice);
+		Search(soln);
 		soln.pop_back();
 
-		MarkBoard(boardNC, choice, 0);
-		AddTiles(boardNC, tilesidxsNC, removed);
+		MarkBoard(choice, 0); // all tiles covering choice are out of play, so count is zero
+		AddTiles(markChoice);
+		if (Stopped()) { break; }
 	}
+	AddTiles(markCol);
 }
 
-ACX::TilesIdxs ACX::RemoveTiles(Board& board, TilesIdxs& tilesidxs, const TI col) const
+template<class TI>
+void ACX<TI>::RemoveColTiles(const TI col)
 {
-	TilesIdxs removed;
-	for (TI i(0); i < tilesidxs.size();) { // tiles which intersect col and are removed
-		const auto& tilesidx(tilesidxs[i]);
-		const auto& tile(_start_tiles[tilesidx]);
-		if (!Intersect(tile, col)) { ++i;  continue; }
-		removed.push_back(tilesidx);
-		Subtract(board, tile);
-		tilesidxs.erase(tilesidxs.begin() + i); // expensive? -> no
+	for (TI i(0); i < _live;) { // tiles in play which intersect col are removed
+		const TI tile(_tilesidxs[i]);
+		if (!Intersect(tile, col)) { ++i; continue; }
+		Subtract(tile);
+		_tilesidxs[i] = _tilesidxs[--_live]; // swap removal, check the moved tile next
+		_tilesidxs[_live] = tile;
 	}
-	return removed; // elided
 }
 
-ACX::TilesIdxs ACX::RemoveTiles(Board& board, TilesIdxs& tilesidxs, const Tile& choice) const
+template<class TI>
+void ACX<TI>::RemoveMarkedTiles()
 {
-	TilesIdxs removed;
-	for (TI i(0); i < tilesidxs.size();) { // tiles which intersect tile and are removed
-		const auto& tilesidx(tilesidxs[i]);
-		const auto& tile(_start_tiles[tilesidx]);
-		if (!Intersect(tile, choice)) {	++i; continue;	}
-		removed.push_back(tilesidx);
-		Subtract(board, tile);
-		tilesidxs.erase(tilesidxs.begin() + i); // expensive? -> no
+	// Board positions of the choice are marked, tiles in play never cover other
+	// marked positions. So a tile intersects the choice if it covers a marked position.
+	for (TI i(0); i < _live;) { // tiles in play which intersect choice are removed
+		const TI tile(_tilesidxs[i]);
+		if (!Intersect(tile)) { ++i; continue; }
+		Subtract(tile);
+		_tilesidxs[i] = _tilesidxs[--_live]; // swap removal, check the moved tile next
+		_tilesidxs[_live] = tile;
 	}
-	return removed; // elided
 }
 
-void ACX::AddTiles(Board& board, TilesIdxs& tilesidxs, const TilesIdxs& removed) const
+template<class TI>
+void ACX<TI>::AddTiles(const TI mark)
 {
-	for (TI i(0); i < removed.size();) { // tiles which intersect col and were removed
-		const auto& tilesidx(tilesidxs[i]);
-		const auto& tile(_start_tiles[tilesidx]);
-		Add(board, tile);
-		tilesidxs.push_back(i);
+	for (TI i(_live); i < mark; ++i) { // tiles removed since _live was mark
+		Add(_tilesidxs[i]);
 	}
+	_live = mark;
 }
 
-bool ACX::Intersect(const Tile& tile, const TI col) const
+template<class TI>
+bool ACX<TI>::Intersect(const TI tile, const TI col) const
 {
-	for (const auto& pos : tile) {
-		if (col == pos) { return true; }
+	for (TI i(_first[tile]); i < _first[tile + 1]; ++i) {
+		if (col == _cell[i]) { return true; }
 	}
 	return false;
 }
 
-bool ACX::Intersect(const Tile& tile1, const Tile& tile2) const
+template<class TI>
+bool ACX<TI>::Intersect(const TI tile) const
 {
-	for (TI j(0), k(0); j < tile1.size() && k < tile2.size();) { // each square in tiles
-		const TI& pos1(tile1[j]);
-		const TI& pos2(tile2[k]);
-		if      (pos1 < pos2) { ++j; }
-		else if (pos1 > pos2) { ++k; }
-		else { return true; } // collision
+	for (TI i(_first[tile]); i < _first[tile + 1]; ++i) {
+		if (numeric_limits<TI>::max() == _board[_cell[i]]) { return true; } // collision with marked position
 	}
 	return false;
 }
 
-void ACX::MarkBoard(Board & board, const Tile & choice, const TI val) const
+template<class TI>
+void ACX<TI>::MarkBoard(const TI choice, const TI val)
 {
 	// choice tile board positions are now at zero coverage
 	// mark covered board squares
-	for (const auto& pos : choice) {
-		board[pos] = val;
+	for (TI i(_first[choice]); i < _first[choice + 1]; ++i) {
+		_board[_cell[i]] = val;
 	}
 }
 
-void ACX::Subtract(Board& board, const Tile& tile) const
+template<class TI>
+void ACX<TI>::Subtract(const TI tile)
 {
-	for (const auto& pos : tile) { // all positions in tile
-		--board[pos];
+	for (TI i(_first[tile]); i < _first[tile + 1]; ++i) { // all positions in tile
+		TI& count(_board[_cell[i]]);
+		if (numeric_limits<TI>::max() != count) { --count; } // marked positions keep their mark
 	}
 }
 
-void ACX::Add(Board & board, const Tile & tile) const
+template<class TI>
+void ACX<TI>::Add(const TI tile)
 {
-	for (const auto& pos : tile) { // all positions in tile
-		++board[pos];
+	for (TI i(_first[tile]); i < _first[tile + 1]; ++i) { // all positions in tile
+		++_board[_cell[i]];
 	}
 }
 
-ACX::TI ACX::ChooseColumn(const Board& board) const
+template<class TI>
+TI ACX<TI>::ChooseColumn() const
 {
 	// minimize search space by selecting most constrained column
 	TI iMin(0); // assume first square on board
 	for (TI i(1); i < _pc; ++i) { // limit search to primary constraints
-		if (board[iMin] > board[i]) { iMin = i; }
+		if (_board[iMin] > _board[i]) { iMin = i; }
 	}
 	return iMin;
 }
 
-void ACX::ShowSoln(const TilesIdxs& soln) const
+template<class TI>
+void ACX<TI>::ShowSoln(const TilesIdxs& soln) const
 {
-	cout << "[\n";
-	for (const auto& tilesidx : soln) { // all solution tile indices
-		const Tile& tile(_start_tiles[tilesidx]);
-		for (const auto& pos : tile) { // each position in tile
-			cout << pos << " ";
-		}
-		cout << "\n";
-	}
-	cout << "]\n";
+	_show(Soln(soln.begin(), soln.end())); // tile index is the input row number
 }
 
+// index types, see acx.h
+template class ACX<uint16_t>;
+template class ACX<uint32_t>;
+template class ACX<uint64_t>;
@@ -3,42 +3,45 @@
 // Bill Ola Rasmussen
 
 #include "Solver.h"
+#include "ProblemMatrix.h"
 #include <vector>
-//#include <cstdint>
+#include <cstdint>
+#include <algorithm>
 
+// TI: index type, instantiated for the C++11 <cstdint> types:
+//	uint16_t	0 to        65,535	2 bytes
+//	uint32_t	0 to 4,294,967,295	4 bytes, same as Microsoft unsigned int
+//	uint64_t	very large problems
+// uint8_t is not instantiated, problems that fit are too small to benefit.
+template<class TI>
 class ACX : public Solver {
-	// C++11 <cstdint> types:
-	//	uint8_t		0 to           255	1 byte
-	//	uint16_t	0 to        65,535	2 bytes
-	//	uint32_t	0 to 4,294,967,295	4 bytes, same as Microsoft unsigned int
-	using TI = unsigned int; // index type
-	unsigned int _pc; // primary constraints, size of _start_board or less
+	unsigned int _pc; // primary constraints, size of _board or less
 	using Board = std::vector<TI>;
-	Board _start_board;
-	using Tile = std::vector<TI>;
-	using Tiles = std::vector<Tile>;
+	Board _board; // cover count for each column, single board shared by all search levels
+	using Cells = std::vector<TI>;
+	Cells _cell; // board positions of all tiles, stored back to back
+	Cells _first; // index into _cell of the first position of each tile, plus end marker
 	using TilesIdxs = std::vector<TI>;
-	Tiles _start_tiles; // all available tiles
-	bool _show;
+	TilesIdxs _tilesidxs; // sparse set: [0,_live) tiles in play, [_live,end) removed tiles in removal order
+	TI _live; // count of tiles in play
+	Show _show;
 	std::function<void(Event)> _notify;
-	void ShrinkToFit(); // optional optimization
-	void Search(TilesIdxs& soln, const Board& board, const TilesIdxs& tilesidxs) const;
-	TilesIdxs RemoveTiles(Board& board, TilesIdxs& tilesidxs, const TI col) const;
-	TilesIdxs RemoveTiles(Board& board, TilesIdxs& tilesidxs, const Tile& choice) const;
-	void AddTiles(Board& board, TilesIdxs& tilesidxs, const TilesIdxs& removed) const;
-	bool Intersect(const Tile& tile, const TI col) const;
-	bool Intersect(const Tile& tile1, const Tile& tile2) const;
-	void MarkBoard(Board& board, const Tile& choice, const TI val) const;
-	void Subtract(Board& board, const Tile& tile) const;
-	void Add(Board& board, const Tile& tile) const;
-	TI ChooseColumn(const Board& board) const;
+	unsigned long long Sum() const; // checksum of board cover counts
+	void Search(TilesIdxs& soln);
+	void RemoveColTiles(const TI col);
+	void RemoveMarkedTiles();
+	void AddTiles(const TI mark);
+	bool Intersect(const TI tile, const TI col) const;
+	bool Intersect(const TI tile) const;
+	void MarkBoard(const TI choice, const TI val);
+	void Subtract(const TI tile);
+	void Add(const TI tile);
+	TI ChooseColumn() const;
 	void ShowSoln(const TilesIdxs& soln) const;
 public:
-	ACX() {}
-	void Init(const unsigned int pc, const unsigned int sc) override;
-	void Row(const unsigned int col) override;
-	void Col(const unsigned int col) override;
-	void Solve(const bool showSoln, std::function<void(Event)>CallBack) override;
+	explicit ACX(const ProblemMatrix& pm);
+	static std::size_t MaxIndex(const ProblemMatrix& pm) { return std::max(std::max(pm.Nodes(), std::size_t(pm.Rows())), std::size_t(pm.Cols())); } // max is the covered mark
+	void Solve(Show ShowSoln, std::function<void(Event)>CallBack) override;
 	ACX&operator=(const ACX&) = delete; // no assignment
 	ACX(const ACX&) = delete; // no copy constructor
 };
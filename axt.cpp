@@ -25,7 +25,7 @@ unsigned int countTileConflicts(const VVUI& vtile, const VUI& target)
 	return --conflicts;
 }
 
-Tiles::Tiles(const VVUI& vtile) : tileStorage(vtile.size())
+Tiles::Tiles(const VVUI& vtile, ostream& out) : tileStorage(vtile.size())
 {
 	assert(vtile.size() == tileStorage.size());
 	const auto size(vtile.size());
@@ -40,43 +40,34 @@ Tiles::Tiles(const VVUI& vtile) : tileStorage(vtile.size())
 	unsigned int conflictCount(0);
 	for (VVUI::size_type i(0); i < size; ++i) {
 		const auto nConflict(countTileConflicts(vtile, vtile[i]));
-		cout << "nConflict " << nConflict << endl;
+		out << "nConflict " << nConflict << endl;
 		conflictCount += nConflict;
 		tileStorage[i].conflictStorage.resize(nConflict);
 	}
-	cout << "conflict total: " << conflictCount << endl;
+	out << "conflict total: " << conflictCount << endl;
 }
 
 // -=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
 
-void AXT::Init(const unsigned int pc, const unsigned int sc)
+AXT::AXT(const ProblemMatrix& pm) : npc(pm.Primary()), constraint(pm.Cols()), vtile(pm.Rows())
 {
-	npc = pc;
-	constraint.resize(pc+sc); // value-initialized to zero
-}
-
-void AXT::Row(const unsigned int col)
-{
-	vtile.push_back(VUI());
-	itCurTile = prev(vtile.end());
-	Col(col);
-}
-
-void AXT::Col(const unsigned int col)
-{
-	assert(col < constraint.size());
-	itCurTile->push_back(col);
-	++constraint[col];
+	for (unsigned int c(0); c < pm.Cols(); ++c) {
+		constraint[c] = pm.ColSize(c);
+	}
+	for (unsigned int r(0); r < pm.Rows(); ++r) {
+		vtile[r].assign(pm.RowBegin(r), pm.RowEnd(r));
+	}
 }
 
-void AXT::Solve(const bool showSoln, function<void(Event)> CallBack)
+void AXT::Solve(Show ShowSoln, function<void(Event)> CallBack)
 {
-	show = showSoln;
+	show = ShowSoln;
 	Notify = CallBack;
 
-	cout << "AXT::Solve with " << vtile.size() << " tiles\n";
-	Tiles tiles(vtile); // solving structure
+	*out << "AXT::Solve with " << vtile.size() << " tiles\n";
+	Tiles tiles(vtile, *out); // solving structure
 
+	found = 0;
 	Notify(Event::Begin);
 	// Search
 	Notify(Event::End);
@@ -2,6 +2,7 @@
 // Bill Ola Rasmussen
 
 #include "Solver.h"
+#include "ProblemMatrix.h"
 #include <vector>
 
 using VUI = std::vector<unsigned int>;
@@ -28,24 +29,20 @@ class Tiles {
 	// as that code will not compile due to Tile's deleted copy constructor.
 	std::vector<Tile> tileStorage; // stored here but manipulated via dance
 public:
-	Tiles(const VVUI& vtile); // linkup Tiles from initialization storage
+	Tiles(const VVUI& vtile, std::ostream& out); // linkup Tiles from initialization storage
 	Tiles&operator=(const Tiles&) = delete; // no assignment
 	Tiles(const Tiles&) = delete; // no copy constructor
 };
 
 class AXT :public Solver {
 	std::function<void(Event)>Notify;
-	bool show;
+	Show show;
 	unsigned int npc; // number of primary constraints
 	VUI constraint;
 	VVUI vtile;
-	decltype(vtile.end()) itCurTile;
 public:
-	AXT() = default;
-	void Init(const unsigned int pc, const unsigned int sc) override;
-	void Row(const unsigned int col) override;
-	void Col(const unsigned int col) override;
-	void Solve(const bool showSoln, std::function<void(Event)>CallBack) override;
+	explicit AXT(const ProblemMatrix& pm);
+	void Solve(Show ShowSoln, std::function<void(Event)>CallBack) override;
 	AXT&operator=(const AXT&) = delete; // no assignment
 	AXT(const AXT&) = delete; // no copy constructor
 };
@@ -0,0 +1,44 @@
+#!/usr/bin/env python3
+# Benchmark interleaved dlx2 search against plain dlx2
+# Bill Ola Rasmussen
+# version 1.0
+
+# Counts the solutions of each problem file with dlx2, then with
+# -interleave=N for each lane count, and reports the search time and the
+# speedup over plain dlx2 per instance. Interleaving pays off when the
+# structures do not fit the caches, on small problems it costs the extra
+# turns, see ilx.h. Example:
+#   benchInterleave.py ./solve 2,4,8 pent_11_20.txt queens_14.txt
+
+import subprocess
+import sys
+
+def searchTime(solve,fileName,options):
+    'run a counting dlx2 search, return solution count and search time'
+    out=subprocess.run([solve,'-q',fileName,'dlx2']+options,
+                       stdout=subprocess.PIPE,universal_newlines=True).stdout
+    for line in out.splitlines():
+        if 'solution(s) found, full solve time:' in line:
+            f=line.split()
+            return f[0],float(f[6])
+    raise RuntimeError('no solve time in solver output:\n'+out)
+
+def bench(solve,lanes,fileName):
+    print(fileName)
+    print('%10s %12s %10s %8s'%('lanes','solutions','seconds','speedup'))
+    count,base=searchTime(solve,fileName,[])
+    print('%10s %12s %10.3f %8s'%('plain',count,base,''))
+    for n in lanes:
+        c,t=searchTime(solve,fileName,['-interleave='+str(n)])
+        if c!=count:
+            raise RuntimeError('interleaved count '+c+' differs from '+count)
+        print('%10d %12s %10.3f %8.2f'%(n,c,t,base/t if t else float('inf')))
+
+if __name__ == "__main__":
+    if len(sys.argv)<4:
+        print('usage: '+sys.argv[0]+' solve lanes[,lanes...] problem files...')
+        sys.exit(1)
+    solve=sys.argv[1]
+    lanes=[int(n) for n in sys.argv[2].split(',')]
+    for fileName in sys.argv[3:]:
+        bench(solve,lanes,fileName)
@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+# Benchmark solver input load time
+# Bill Ola Rasmussen
+# version 1.0
+
+# Loads square Y pentomino boards of doubling area with the -loadonly option
+# and reports load time per node. Linear loading shows a constant time per
+# node as the board grows. Read is parsing and validation, build is the
+# construction of the solver structure from the parsed problem.
+
+import contextlib
+import os
+import subprocess
+import sys
+import tempfile
+import CreateYpentominoData
+
+def createInput(fileName,n):
+    'write n x n Y pentomino problem, return row and node counts'
+    with open(fileName,'w') as f, contextlib.redirect_stdout(f):
+        CreateYpentominoData.exactCoverSpec(n,n)
+    b=CreateYpentominoData.Board(n,n)
+    rows=list(b.constraints())
+    return len(rows),sum(len(r) for r in rows)
+
+def loadTime(solve,solver,fileName):
+    'run solver on file without search, return reported input read and build times'
+    out=subprocess.run([solve,'-q',fileName,solver,'-loadonly'],
+                       stdout=subprocess.PIPE,universal_newlines=True).stdout
+    read=build=None
+    for line in out.splitlines():
+        if line.startswith('input read time:'):
+            read=float(line.split()[3])
+        if line.startswith('build time:'):
+            build=float(line.split()[2])
+    if read is None or build is None:
+        raise RuntimeError('no load time in solver output:\n'+out)
+    return read,build
+
+def bench(solve,solver,sizes):
+    print('solver',solver)
+    print('%6s %10s %10s %10s %10s %14s'%('board','rows','nodes','read','build','ns per node'))
+    with tempfile.TemporaryDirectory() as d:
+        fileName=os.path.join(d,'input.txt')
+        for n in sizes:
+            rows,nodes=createInput(fileName,n)
+            read,build=loadTime(solve,solver,fileName)
+            print('%6d %10d %10d %10.3f %10.3f %14.1f'%(n,rows,nodes,read,build,(read+build)*1e9/nodes))
+
+if __name__ == "__main__":
+    solve=sys.argv[1] if len(sys.argv)>1 else './solve'
+    solvers=sys.argv[2:] if len(sys.argv)>2 else ['dix','dlx2']
+    sizes=[25,35,50,71,100,141,200] # area doubles with each step
+    for solver in solvers:
+        bench(solve,solver,sizes)
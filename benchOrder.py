@@ -0,0 +1,46 @@
+#!/usr/bin/env python3
+# Benchmark time to first solution of the dlx2 row orders
+# Bill Ola Rasmussen
+# version 1.0
+
+# Each problem is generated in process, see exactcover.py, then dlx2 looks
+# for its first solution once per row order, see Solver::Order. Reports the
+# time and the speedup over input order; a search that takes longer than
+# the time limit is reported as such. Example:
+#   benchOrder.py 30 queens:40 pentomino:15:15 pentomino:11:30
+
+import sys
+import time
+import exactcover
+
+ORDERS=('input','eliminate','learned')
+
+def first(args,order,seconds):
+    'time to the first solution, None if out of time'
+    with exactcover.problem(args) as p:
+        begin=time.perf_counter()
+        p.solve(solver='dlx2',order=order,limit=1,keep=0,seconds=seconds)
+        t=time.perf_counter()-begin
+        return t if p.status()=='limit' else None
+
+def bench(args,seconds):
+    print(' '.join(args))
+    print('%10s %10s %8s'%('order','seconds','speedup'))
+    base=None
+    for order in ORDERS:
+        t=first(args,order,seconds)
+        if t is None:
+            print('%10s %10s'%(order,'>%g'%seconds))
+            continue
+        if order=='input':
+            base=t
+        speedup='%8.2f'%(base/t) if base and t else ''
+        print('%10s %10.3f %s'%(order,t,speedup))
+
+if __name__ == "__main__":
+    if len(sys.argv)<3:
+        print('usage: '+sys.argv[0]+' seconds problem... (problem: queens:N or pentomino:W:H)')
+        sys.exit(1)
+    seconds=float(sys.argv[1])
+    for spec in sys.argv[2:]:
+        bench(spec.split(':'),seconds)
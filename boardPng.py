@@ -4,8 +4,10 @@
 # version 1.0
 
 import sys
-import png # https://github.com/drj11/pypng
-# unable to get 2to3 for pypng working, so env is 2.x for now
+import struct
+import zlib
+
+MAGIC=b'ECS1' # binary solution stream, see SolnStream.h
 
 class BoardImage:
     def __init__(self,w,h,lineWidth,cellWidth):
@@ -34,6 +36,8 @@ class BoardImage:
         if y<self.h-1 and self.ToIdx(x,y+1) in ids:
             self.Cell(xb,yb+self.cw/2) # break S wall
     def Write(self,fileName):
+        import png # https://github.com/drj11/pypng, not needed for -decode
+        # unable to get 2to3 for pypng working, so env is 2.x for now
         f=open(fileName,'wb')
         palette=[(0xF0,0xF0,0xF0),(0x00,0x00,0xF0)]
         w=png.Writer(len(self.bits[0]),len(self.bits),palette=palette,bitdepth=1)
@@ -45,9 +49,63 @@ def addTile(image,ids):
         assert -1<i<image.w*image.h
         image.TilePart(i,ids)
 
-def parseInput(image):
+def varint(data,pos):
+    'decode one varint at pos, return value and next position'
+    x,shift=0,0
+    while True:
+        b=data[pos]
+        pos+=1
+        x|=(b&0x7f)<<shift
+        if not b&0x80:
+            return x,pos
+        shift+=7
+
+def decodeSolutions(stream):
+    'yield solutions as lists of row numbers from a binary solution stream, magic already read'
+    while True:
+        head=stream.read(8)
+        if len(head)<8:
+            return
+        raw,packed=struct.unpack('<II',head)
+        data=bytearray(zlib.decompress(stream.read(packed)))
+        assert len(data)==raw
+        pos,prev=0,[] # each block decodes independently
+        while pos<len(data):
+            keep,pos=varint(data,pos)
+            add,pos=varint(data,pos)
+            soln=prev[:keep]
+            for i in range(add):
+                r,pos=varint(data,pos)
+                soln.append(r)
+            prev=soln
+            yield soln
+
+def problemRows(w,h,fileName):
+    'row number to cell ids: from solver input file, or regenerated Y pentomino rows'
+    if fileName is None:
+        import CreateYpentominoData
+        return list(CreateYpentominoData.Board(w,h).constraints())
+    rows,parse=[],0
+    for line in open(fileName):
+        words=line.split()
+        if not len(words):
+            continue
+        if ']'==words[0]:
+            break
+        if '['==words[0]:
+            parse=1
+            continue
+        if parse==1: # constraint counts
+            parse=2
+            continue
+        if parse:
+            rows.append([int(a) for a in words])
+    return rows
+
+def parseLines(image,lines):
+    'text solution format: first solution between [ and ]'
     parse=False
-    for line in sys.stdin:
+    for line in lines:
         words=line.split()
         if not len(words):
             continue
@@ -60,16 +118,55 @@ def parseInput(image):
             ids=[int(a) for a in words]
             addTile(image,ids)
 
-def main(w,h):
+def textLines(stream,head):
+    'lines of a byte stream which starts with head'
+    for line in (head+stream.readline()).splitlines(True): # head may hold a line break
+        yield line.decode('ascii')
+    line=stream.readline()
+    while line:
+        yield line.decode('ascii')
+        line=stream.readline()
+
+def parseInput(image,problemFile):
+    'draw first solution from stdin, text or binary solution stream'
+    stream=getattr(sys.stdin,'buffer',sys.stdin) # bytes in both python 2 and 3
+    head=stream.read(len(MAGIC))
+    if head!=MAGIC:
+        parseLines(image,textLines(stream,head))
+        return
+    rows=problemRows(image.w,image.h,problemFile)
+    for soln in decodeSolutions(stream):
+        for r in soln:
+            addTile(image,rows[r])
+        break
+
+def decode(problemFile):
+    'write binary solution stream from stdin as text solution format'
+    stream=getattr(sys.stdin,'buffer',sys.stdin)
+    if stream.read(len(MAGIC))!=MAGIC:
+        raise ValueError('not a binary solution stream')
+    rows=problemRows(0,0,problemFile)
+    for soln in decodeSolutions(stream):
+        sys.stdout.write('[\n')
+        for r in soln:
+            sys.stdout.write(' '.join(map(str,rows[r]))+' \n')
+        sys.stdout.write(']\n')
+
+def main(w,h,problemFile):
     print('boardPng')
     image=BoardImage(w,h,3,20)
-    parseInput(image)
+    parseInput(image,problemFile)
     image.Write('out.png')
     print('done.')
 
 if __name__ == "__main__":
     import sys
-    if len(sys.argv) == 3:
-        main(int(sys.argv[1]),int(sys.argv[2]))
+    if len(sys.argv) == 3 and sys.argv[1] == '-decode':
+        decode(sys.argv[2])
+    elif len(sys.argv) in (3,4):
+        main(int(sys.argv[1]),int(sys.argv[2]),sys.argv[3] if len(sys.argv)==4 else None)
     else:
-        print('usage: '+sys.argv[0]+' [width] [height]')
+        print('usage: '+sys.argv[0]+' [width] [height] [problem file]')
+        print('       '+sys.argv[0]+' -decode [problem file] : binary solution stream to text')
+        print('stdin: text solutions, or binary solution stream decoded with the problem')
+        print('file or, if none is given, with regenerated Y pentomino rows')
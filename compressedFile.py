@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+# Compressed output files for the problem generators
+# Bill Ola Rasmussen
+# version 1.0
+
+# The file name picks the format: name.gz is gzip, name.zst is zstd, anything
+# else plain text. zstd uses the compression.zstd module of Python 3.14 when
+# present, the zstd program otherwise. The solver recognizes either format
+# from the data itself, on files and on stdin, see Inflate.h. Example:
+#   CreateYpentominoData.py 100 100 -o y100.txt.gz
+#   solve -q y100.txt.gz dlx2
+
+import contextlib
+import gzip
+import io
+import shutil
+import subprocess
+import sys
+
+def takeOutput(args):
+    'remove "-o file" from the argument list, return remaining arguments and file name or None'
+    if '-o' not in args:
+        return args,None
+    i=args.index('-o')
+    if i+1==len(args):
+        raise ValueError('-o needs a file name')
+    return args[:i]+args[i+2:],args[i+1]
+
+class ZstdProgram(object):
+    'text file writing through the zstd program'
+    def __init__(self,fileName):
+        self.p=subprocess.Popen(['zstd','-q','-f','-o',fileName],stdin=subprocess.PIPE)
+        self.f=io.TextIOWrapper(self.p.stdin,encoding='ascii')
+    def write(self,s):
+        return self.f.write(s)
+    def flush(self):
+        self.f.flush()
+    def close(self):
+        self.f.close()
+        if self.p.wait():
+            raise RuntimeError('zstd exited with '+str(self.p.returncode))
+    def __enter__(self):
+        return self
+    def __exit__(self,*exc):
+        self.close()
+
+def openOutput(fileName):
+    'text file for writing, compressed by file name suffix; None: stdout, left open'
+    if fileName is None:
+        return contextlib.nullcontext(sys.stdout)
+    if fileName.endswith('.gz'):
+        return gzip.open(fileName,'wt',compresslevel=6) # default 9 is slow for little gain on this data
+    if fileName.endswith('.zst'):
+        try:
+            from compression import zstd
+            return zstd.open(fileName,'wt')
+        except ImportError:
+            pass
+        if not shutil.which('zstd'):
+            raise RuntimeError('writing '+fileName+' needs the zstd program or Python 3.14')
+        return ZstdProgram(fileName)
+    return open(fileName,'w')
@@ -0,0 +1,209 @@
+// dancing cells solver: sparse set swaps over contiguous arrays instead of linked list removal
+// Bill Ola Rasmussen
+
+#include "dcx.h"
+#include <stdexcept>
+#include <iostream>
+#include <limits>
+using namespace std;
+
+// ---------- build data structure from input ----------
+
+template<class TI>
+DCX<TI>::DCX(const ProblemMatrix& pm) : _pc(pm.Primary())
+{
+	if (MaxIndex(pm) >= numeric_limits<TI>::max()) { throw(runtime_error("too many nodes for index type")); }
+	// primary item: cover this exactly once
+	// secondary item: cover this at most once
+	_start.resize(pm.Cols());
+	_size.resize(pm.Cols());
+	for (TI i(0); i < pm.Cols(); ++i) {
+		_start[i] = pm.ColBegin(i) - pm.ColBegin(0); // slices in column order, as the problem matrix keeps them
+		_size[i] = pm.ColSize(i);
+	}
+	_node.resize(pm.Nodes());
+	_set.resize(pm.Nodes());
+	_first.reserve(pm.Rows() + 1);
+	vector<TI> next(_start); // next free position in each item's slice
+	TI x(0);
+	for (ProblemMatrix::TI r(0); r < pm.Rows(); ++r) { // options in input order
+		_first.push_back(x);
+		for (auto p(pm.RowBegin(r)); p != pm.RowEnd(r); ++p, ++x) {
+			const TI loc(next[*p]++);
+			_node[x] = { TI(*p), loc, TI(r) };
+			_set[loc] = x;
+		}
+	}
+	_first.push_back(x);
+	_item.resize(_pc);
+	_where.resize(_pc);
+	for (TI i(0); i < _pc; ++i) { _item[i] = _where[i] = i; }
+	_active = _pc;
+}
+
+// ---------- solve exact cover problem ----------
+
+template<class TI>
+void DCX<TI>::Solve(Show ShowSoln, std::function<void(Event)> CallBack)
+{
+	_show = ShowSoln;
+	_notify = CallBack;
+	*out << "DCX::Solve with " << _start.size() << " items, " << _node.size() << " nodes\n";
+
+	// save for later integrity check, only as much as the check mode needs
+	const unsigned long long check_sum(Check::Sum == check ? Sum() : 0);
+	const vector<TI> check_state(Check::Full == check ? State() : vector<TI>());
+
+	vector<TI> soln;
+	found = 0;
+	_notify(Event::Begin);
+	Search(soln);
+	_notify(Event::End);
+
+	if (Check::Off != check && _active != _pc) { throw(runtime_error("item list integrity failure")); }
+	if (Check::Off != check) {
+		for (TI x(0); x < _node.size(); ++x) {
+			if (_set[_node[x].loc] != x) { throw(runtime_error("cell position integrity failure")); }
+		}
+	}
+	if (Check::Sum == check && check_sum != Sum()) { throw(runtime_error("cell checksum failure")); }
+	if (Check::Full == check && check_state != State()) { throw(runtime_error("cell integrity failure")); }
+	if (Check::Off != check) { *out << "Cell structure integrity verified.\n"; }
+}
+
+template<class TI>
+unsigned long long DCX<TI>::Sum() const
+{
+	CheckSum s;
+	unsigned long long items(0);
+	for (TI k(0); k < _active; ++k) { items += _item[k]; }
+	s.Add(_active).Add(items);
+	for (TI i(0); i < _start.size(); ++i) {
+		unsigned long long live(0);
+		for (TI k(_start[i]); k < _start[i] + _size[i]; ++k) { live += _set[k]; }
+		s.Add(_size[i]).Add(live);
+	}
+	return s.Value();
+}
+
+template<class TI>
+vector<TI> DCX<TI>::State() const
+{
+	vector<TI> v(_item.begin(), _item.begin() + _active);
+	sort(v.begin(), v.end());
+	for (TI i(0); i < _start.size(); ++i) {
+		v.push_back(_size[i]);
+		const auto b(v.size());
+		v.insert(v.end(), _set.begin() + _start[i], _set.begin() + _start[i] + _size[i]);
+		sort(v.begin() + b, v.end());
+	}
+	return v;
+}
+
+template<class TI>
+void DCX<TI>::Search(vector<TI>& soln)
+{
+	if (!_active) { // all primary items are covered
+		++found;
+		_notify(Event::Soln);
+		if (_show) { ShowSoln(soln); }
+		return;
+	}
+
+	const TI i(ChooseItem());
+	if (!_size[i]) { return; } // an item could not be covered with remaining options, abort this search branch
+	if (!_show && 1 == _active) { // counting, one primary item left: each of its options completes a solution
+		found += _size[i];
+		_notify(Event::Soln);
+		return;
+	}
+
+	Cover(i);
+	const TI end(_start[i] + _size[i]); // the slice of a covered item does not change below
+	for (TI k(_start[i]); k < end; ++k) {
+		const TI x(_set[k]);
+		const TI o(_node[x].opt);
+		soln.push_back(o);
+		for (TI y(_first[o]); y < _first[o + 1]; ++y) { // other items of the option
+			if (y != x) { Cover(_node[y].itm); }
+		}
+
+		Search(soln);
+
+		for (TI y(_first[o + 1]); y-- > _first[o];) { // reverse order
+			if (y != x) { Uncover(_node[y].itm); }
+		}
+		soln.pop_back();
+		if (Stopped()) { break; }
+	}
+	Uncover(i);
+}
+
+template<class TI>
+void DCX<TI>::Cover(const TI i) // take item out of play, hide its options from all other items
+{
+	if (i < _pc) { // primary: swap out of the active items
+		const TI last(_item[--_active]), w(_where[i]);
+		_item[w] = last;
+		_where[last] = w;
+		_item[_active] = i;
+		_where[i] = _active;
+	}
+	const TI end(_start[i] + _size[i]);
+	for (TI k(_start[i]); k < end; ++k) { Hide(_set[k]); }
+}
+
+template<class TI>
+void DCX<TI>::Uncover(const TI i)
+{
+	for (TI k(_start[i] + _size[i]); k-- > _start[i];) { Unhide(_set[k]); }
+	if (i < _pc) { ++_active; } // i is right behind the active items
+}
+
+template<class TI>
+void DCX<TI>::Hide(const TI x) // hide the option of node x from its items other than x's
+{
+	const TI o(_node[x].opt);
+	for (TI y(_first[o]); y < _first[o + 1]; ++y) {
+		if (y == x) { continue; }
+		const TI j(_node[y].itm);
+		const TI last(_start[j] + --_size[j]), p(_node[y].loc);
+		const TI z(_set[last]); // swap y to the end of the live part
+		_set[p] = z;
+		_node[z].loc = p;
+		_set[last] = y;
+		_node[y].loc = last;
+	}
+}
+
+template<class TI>
+void DCX<TI>::Unhide(const TI x)
+{
+	const TI o(_node[x].opt);
+	for (TI y(_first[o + 1]); y-- > _first[o];) {
+		if (y != x) { ++_size[_node[y].itm]; }
+	}
+}
+
+template<class TI>
+TI DCX<TI>::ChooseItem() const
+{
+	// minimize search space by selecting most constrained item
+	TI iMin(_item[0]);
+	for (TI k(1); k < _active && _size[iMin]; ++k) {
+		const TI i(_item[k]);
+		if (_size[i] < _size[iMin]) { iMin = i; }
+	}
+	return iMin;
+}
+
+template<class TI>
+void DCX<TI>::ShowSoln(const vector<TI>& soln) const
+{
+	_show(Soln(soln.begin(), soln.end())); // options are input rows
+}
+
+// index types, see dcx.h
+template class DCX<uint16_t>;
+template class DCX<uint32_t>;
+template class DCX<uint64_t>;
@@ -0,0 +1,50 @@
+// dancing cells solver: sparse set swaps over contiguous arrays instead of linked list removal
+// see Knuth, The Art of Computer Programming, Volume 4B, 7.2.2.3 (dancing cells)
+// Bill Ola Rasmussen
+#pragma once
+
+#include "Solver.h"
+#include "ProblemMatrix.h"
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+// Each item (column) owns a slice of _set holding the nodes of its options
+// (rows). The first _size[i] entries are the options still in play; an option
+// is hidden from an item by swapping its node to the end of the live part and
+// shrinking the size. Undo only grows the sizes again in reverse order, the
+// hidden nodes are still right behind the live part. Active primary items are
+// a sparse set in _item the same way. Order inside a set changes during the
+// search, its contents do not.
+//
+// TI: index type, instantiated for uint16_t, uint32_t and uint64_t.
+template<class TI>
+class DCX : public Solver {
+	struct Node {
+		TI itm, loc, opt; // item, position in _set, option (input row)
+	};
+	TI _pc; // primary items are 0 to _pc-1
+	std::vector<Node> _node; // nodes of all options, back to back in input order
+	std::vector<TI> _first; // index into _node of the first node of each option, plus end marker
+	std::vector<TI> _set; // node indices, grouped by item
+	std::vector<TI> _start, _size; // each item's slice of _set, its live part
+	std::vector<TI> _item, _where; // sparse set: [0,_active) primary items to cover, position of each in _item
+	TI _active;
+	Show _show;
+	std::function<void(Event)> _notify;
+	unsigned long long Sum() const; // order independent checksum of the live sets
+	std::vector<TI> State() const; // live sets in canonical order, for Check::Full
+	void Search(std::vector<TI>& soln);
+	void Cover(const TI i);
+	void Uncover(const TI i);
+	void Hide(const TI x);
+	void Unhide(const TI x);
+	TI ChooseItem() const;
+	void ShowSoln(const std::vector<TI>& soln) const;
+public:
+	explicit DCX(const ProblemMatrix& pm);
+	static std::size_t MaxIndex(const ProblemMatrix& pm) { return std::max(pm.Nodes(), std::size_t(pm.Cols())); }
+	void Solve(Show ShowSoln, std::function<void(Event)>CallBack) override;
+	DCX&operator=(const DCX&) = delete; // no assignment
+	DCX(const DCX&) = delete; // no copy constructor
+};
@@ -5,117 +5,180 @@
 #include <stdexcept>
 #include <iostream>
 #include <limits>
+#include <algorithm>
 using namespace std;
 
 // ---------- build data structure from input ----------
 
-const DIX::TileNode DIX::SEP{ numeric_limits<DIX::TI>::max(),numeric_limits<DIX::TI>::max(),0 }; // tile separator
+template<class TI>
+const typename DIX<TI>::TileNode DIX<TI>::SEP{ numeric_limits<TI>::max(),numeric_limits<TI>::max(),0 }; // tile separator
 
-void DIX::Init(const unsigned int pc, const unsigned int sc)
+template<class TI>
+DIX<TI>::DIX(const ProblemMatrix& pm)
 {
 	// primary constraint: cover this exactly once
 	// secondary constraint: cover this at most once
-	if (0 == pc+sc) { throw(runtime_error("zero constraint count")); }
+	const TI pc(pm.Primary()), sc(pm.Secondary());
+	_pc = pc;
+	_widest = pm.PrimaryWidth();
+	if (MaxIndex(pm) >= numeric_limits<TI>::max()) { throw(runtime_error("too many nodes for index type")); }
 
 	// create head row vector
 	_head.resize(1+pc+sc); // head node of head nodes, primary constraints, secondary constraints
-	_head[0] = { pc, 1, numeric_limits<TI>::max() }; // head node of head nodes circular link: beginning to end
+	_head[0] = { pc, pc ? TI(1) : TI(0), numeric_limits<TI>::max() }; // head node of head nodes circular link: beginning to end
 	for (TI i(1); i < 1+pc; ++i) {
-		_head[i] = { i-1, i+1, 0 }; // primary constraints: link to both neighbors
+		_head[i] = { TI(i-1), TI(i+1), TI(pm.ColSize(i-1)) }; // primary constraints: link to both neighbors
 	}
 	if (pc) {
 		_head[pc].R = 0; // last primary constraint node, link end to beginning
 	}
 	for (TI i(1+pc); i < 1+pc+sc; ++i) {
-		_head[i] = { i, i, 0 }; // secondary constraints: link to self
+		_head[i] = { i, i, TI(pm.ColSize(i-1)) }; // secondary constraints: link to self
 	}
 
 	// create complete tile array to serve as up/down pointers for head nodes
+	_tile.reserve(1+pc+sc+1+pm.Nodes()+pm.Rows()); // exact final size
 	_tile.push_back(SEP); // unused tile so that head and tile columns have same array index
 	for (TI i(0); i < pc+sc; ++i) {
-		_tile.push_back({ 1+i, 1+i, 1+i }); // link to self, translate 0 based column input to 1 based internal representation
+		_tile.push_back({ TI(1+i), TI(1+i), TI(1+i) }); // link to self, translate 0 based column input to 1 based internal representation
 	}
-	_tile.push_back(SEP);
-}
 
-void DIX::Row(const unsigned int col)
-{
+	// tiles in input order, each preceded by a separator holding its row number
+	_sep.reserve(pm.Rows());
+	for (ProblemMatrix::TI r(0); r < pm.Rows(); ++r) {
+		_sep.push_back(TI(_tile.size()));
+		_tile.push_back({ TI(r), SEP.D, SEP.C });
+		for (auto p(pm.RowBegin(r)); p != pm.RowEnd(r); ++p) {
+			const TI c(1+*p); // translate 0 based column input to 1 based internal representation
+			// previous node in same column: the column list is circular, so the
+			// column's own tile links up to the last node inserted, no search needed
+			const TI iU(_tile[c].U), i(_tile.size());
+			_tile.push_back({ iU,c,c });
+			_tile[c].U = i; // point column to this as last node
+			_tile[iU].D = i; // point previous to this
+		}
+	}
 	_tile.push_back(SEP);
-	Col(col);
-}
-
-void DIX::Col(const unsigned int external_col_id) // external col starts at 0
-{
-	// adjust index
-	const unsigned int c(1+external_col_id); // translate 0 based column input to 1 based internal representation
 
-	// increment node count head array
-	if (c>=_head.size()) { throw(runtime_error("column index out of range")); }
-	_head[c].N++; // increase cover count
-
-	// find previous node in same column
-	TI iU(_tile.size()-1);
-	for(;iU;--iU){ // reverse node/tile search
-		if(c==_tile[iU].C){ break; }
+	if (pm.Weighted()) { // lower bound shares, see Bounded
+		_cost.resize(pm.Rows());
+		_share.resize(_tile.size());
+		for (ProblemMatrix::TI r(0); r < pm.Rows(); ++r) {
+			_cost[r] = pm.RowCost(r);
+			TI width(0);
+			for (TI j(_sep[r] + 1); _tile[j].C; ++j) { width += _tile[j].C <= pc; }
+			for (TI j(_sep[r] + 1); _tile[j].C; ++j) { _share[j] = width ? double(_cost[r]) / width : 0; }
+		}
 	}
-	if (c!=_tile[iU].C) { throw(runtime_error("previous node for column not found")); }
-
-	// insert a new node: overwrite the separator, then push a new one
-	if (!(SEP==_tile.back())) { throw(runtime_error("tile separator not found")); }
-	_tile.back()={ iU,_tile[iU].D,c };
-	_tile[_tile[iU].D].U = _tile.size()-1; // point next to this
-	_tile[iU].D = _tile.size()-1; // point previous to this
-	_tile.push_back(SEP);
 }
 
 // ---------- solve exact cover problem ----------
 
-void DIX::ShrinkToFit()
+template<class TI>
+void DIX<TI>::Solve(Show ShowSoln, std::function<void(Event)> CallBack)
 {
-	// call shrink_to_fit() on all vectors
-	_head.shrink_to_fit();
-	_tile.shrink_to_fit();
+	SolveAssuming(Soln(), Soln(), ShowSoln, CallBack);
 }
 
-void DIX::Solve(const bool showSoln, std::function<void(Event)> CallBack)
+template<class TI>
+void DIX<TI>::SolveAssuming(const Soln& require, const Soln& forbid, Show ShowSoln, std::function<void(Event)> CallBack)
 {
 	if (!(SEP==_tile.back())) { throw(runtime_error("tile separator not found")); }
 
-	_show = showSoln;
+	if (cheapest && _cost.empty()) { throw(runtime_error("cheapest covers need row costs in the input")); }
+	_show = ShowSoln;
 	_notify = CallBack;
-	cout << "DIX::Solve with " << _head.size() << " head nodes, " << _tile.size() << " tiles\n";
-
-	ShrinkToFit(); // vector sizes are now unchanging, so trim extra space
-	const auto check_head(_head); // save for later integrity check
-	const auto check_tile(_tile);
-
-	vector<TI> soln;
+	*out << "DIX::Solve with " << _head.size() << " head nodes, " << _tile.size() << " tiles\n";
+
+	// save for later integrity check, only as much as the check mode needs
+	const unsigned long long check_sum(Check::Sum == check ? Sum() : 0);
+	const auto check_head(Check::Full == check ? _head : vector<HeadNode>());
+	const auto check_tile(Check::Full == check ? _tile : vector<TileNode>());
+
+	vector<TI> soln; // required rows, then rows chosen by search
+	vector<TI> removed; // separators of forbidden rows
+	found = 0;
+	_best.clear();
+	_level = 0;
+	_apart = 0;
+	_parts.clear();
+	_partsBase = 0;
+	_collect = NONE;
 	_notify(Event::Begin);
-	Search(soln);
+	if (Assume(require, forbid, soln, removed)) {
+		_spent = 0;
+		if (cheapest) { for (const auto& i : soln) { _spent += RowCost(i); } }
+		Search(soln);
+	}
+	Unassume(soln, removed);
+	if (cheapest) { // covers are only known to be the cheapest now
+		*out << "least cost covers:";
+		for (const auto& b : _best) { *out << ' ' << b.cost; }
+		*out << '\n';
+		if (_show) { for (const auto& b : _best) { _show(b.rows); } }
+	}
 	_notify(Event::End);
 
-	if (check_head != _head) { throw(runtime_error("head node structure integrity failure")); }
-	if (check_tile != _tile) { throw(runtime_error("tile node structure integrity failure")); }
-	cout << "Node structure integrity verified.\n";
+	if (Check::Sum == check && check_sum != Sum()) { throw(runtime_error("node structure checksum failure")); }
+	if (Check::Full == check && check_head != _head) { throw(runtime_error("head node structure integrity failure")); }
+	if (Check::Full == check && check_tile != _tile) { throw(runtime_error("tile node structure integrity failure")); }
+	if (Check::Off != check) { *out << "Node structure integrity verified.\n"; }
+}
+
+template<class TI>
+unsigned long long DIX<TI>::Sum() const
+{
+	CheckSum s;
+	for (const auto& h : _head) { s.Add(h.L).Add(h.R).Add(h.N); }
+	for (const auto& t : _tile) { s.Add(t.U).Add(t.D).Add(t.C); }
+	return s.Value();
+}
+
+template<class TI>
+void DIX<TI>::Search(vector<TI>& soln)
+{
+	if (Propagate::Off == propagate) { Branch(soln); return; }
+	const size_t mark(_trail.size());
+	if (Propagated(soln)) { Branch(soln); }
+	Unpropagate(mark, soln);
 }
 
-void DIX::Search(vector<TI>& soln)
+// connected: the open columns are one part, no need to look for a split
+template<class TI>
+void DIX<TI>::Branch(vector<TI>& soln, const bool connected)
 {
 	if (!_head[0].R) // head node of head nodes points to itself, indicates all constraints are met
 	{
-		_notify(Event::Soln);
-		if (_show) { ShowSoln(soln); }
+		if (cheapest) { Record(soln); return; }
+		if (_show) { Covered(soln, _partsBase); return; }
+		++found;
+		Notify();
+		return;
+	}
+	if (prune && Pruned()) { return; }
+	if (cheapest && Bounded()) { return; }
+	if (!_show && !cheapest && !_head[_head[0].R].R) { // counting, one primary column left: each of its rows completes a solution
+		if (const TI n = _head[_head[0].R].N) {
+			found += n;
+			Notify();
+		}
 		return;
 	}
 
 	const TI c(ChooseColumn()); // get _head vector index of minimally covered column
 	if (!c) { return; } // a column could not be covered with remaining tiles, abort this search branch
 	// invariant: c > 0
+	if (split && !cheapest && !connected && !(_level % split) && Split(soln)) { return; }
+	if (endgame && !cheapest && Finished(soln)) { return; }
 
+	++_level;
 	Cover(c); // take all tiles covering this node out of play
 
 	for (TI i(_tile[c].D); i!=c; i = _tile[i].D) { // all tiles having nodes in this column (same as those just processed in above cover call)
+		const ProblemMatrix::Cost cost(cheapest ? RowCost(i) : 0);
+		if (cheapest && _best.size() == cheapest && _spent + cost >= _best.back().cost) { continue; } // no cheaper cover with this row
 		soln.emplace_back(i);
+		_spent += cost;
 
 		TI jL(i);
 		for (TI j(i - 1); _tile[j].C; --j) { // all nodes to left of column
@@ -131,6 +194,7 @@ void DIX::Search(vector<TI>& soln)
 
 		Search(soln);
 		soln.pop_back();
+		_spent -= cost;
 
 		for (TI j(jR); j!=i; --j) { // all nodes to right of column, reverse order
 			Uncover(_tile[j].C); 
@@ -139,25 +203,436 @@ void DIX::Search(vector<TI>& soln)
 		for (TI j(jL); j!=i; ++j) { // all nodes to left of column, reverse order
 			Uncover(_tile[j].C); 
 		}
+		if (Stopped()) { break; }
 	}
 	Uncover(c);
+	--_level;
+}
+
+template<class TI>
+bool DIX<TI>::Pruned()
+{
+	_open.clear();
+	for (TI c(_head[0].R); c; c = _head[c].R) { _open.emplace_back(c - 1); } // 0 based column numbers
+	return prune(_open);
+}
+
+// Lower bound of the cost of any cover completing the partial solution: each
+// row's cost is spread evenly over its primary columns, every open column
+// needs a row, so it adds at least its cheapest share. True if even that
+// reaches the cost of the worst cover kept.
+template<class TI>
+bool DIX<TI>::Bounded() const
+{
+	if (_best.size() < cheapest) { return false; } // still taking any cover
+	const double limit(double(_best.back().cost) - 0.5); // costs are whole numbers, rounding can not cut a cheaper cover
+	double least(static_cast<double>(_spent));
+	for (TI c(_head[0].R); c; c = _head[c].R) {
+		double share(numeric_limits<double>::infinity()); // an empty column bounds the branch too
+		for (TI i(_tile[c].D); i != c; i = _tile[i].D) { share = min(share, _share[i]); }
+		least += share;
+		if (least > limit) { return true; }
+	}
+	return false;
+}
+
+template<class TI>
+void DIX<TI>::Record(const vector<TI>& soln)
+{
+	if (_best.size() == cheapest && _spent >= _best.back().cost) { return; } // forced rows may have added to it
+	Best b{ _spent, Soln() };
+	for (const auto& i : soln) { b.rows.emplace_back(RowOf(i)); }
+	auto at(_best.begin());
+	while (_best.end() != at && at->cost <= _spent) { ++at; } // equal costs keep the order found
+	_best.insert(at, move(b));
+	if (_best.size() > cheapest) { _best.pop_back(); }
+	found = _best.size();
+	_notify(Event::Soln);
+}
+
+// true if the bitmask endgame took over the subtree: few primary columns
+// left, and the open columns and the rows still in play fit, see Endgame.h
+template<class TI>
+bool DIX<TI>::Finished(vector<TI>& soln)
+{
+	TI open(0);
+	size_t nodes(0);
+	for (TI c(_head[0].R); c && open <= endgame; c = _head[c].R) {
+		++open;
+		nodes += _head[c].N;
+	}
+	if (open > endgame || nodes > _widest * Endgame::ROWS) { return false; } // too many columns, or surely too many rows
+	_end.Clear(_head.size(), _tile.size());
+	Endgame::Mask need(0);
+	for (TI c(_head[0].R); c; c = _head[c].R) { _end.Map(c, need); } // primary columns get bits in list order
+	for (TI c(_head[0].R); c; c = _head[c].R) {
+		for (TI i(_tile[c].D); i != c; i = _tile[i].D) {
+			if (_end.Marked(i)) { continue; } // added from another column
+			TI first(i);
+			for (; _tile[first - 1].C; --first) {}
+			Endgame::Mask m(0);
+			for (TI j(first); _tile[j].C; ++j) {
+				if (!_end.Map(_tile[j].C, m)) { return false; } // too many secondary columns, maybe further down
+				_end.Mark(j);
+			}
+			if (!_end.Add(m, i)) { return false; }
+		}
+	}
+	_end.Start(need, !_show, stop);
+	while (_end.Next()) {
+		if (_show) {
+			for (const auto& i : _end.Picks()) { soln.emplace_back(TI(i)); } // a tile of each row
+			Covered(soln, _partsBase);
+			soln.resize(soln.size() - _end.Picks().size());
+			continue;
+		}
+		found += _end.Leaf();
+		Notify();
+	}
+	return true;
+}
+
+// ---------- independent parts ----------
+
+// Once rows are chosen the open columns may fall apart into parts that no
+// live row joins, such as separate empty regions of a board: a row of one
+// part neither covers nor clashes with the columns of another, secondary
+// ones included. Searched nested, every cover of one part repeats the whole
+// search of the others. Searched apart, the open column list holds one part
+// at a time. Counting, the part counts multiply, and a part without covers
+// ends the split at once, smallest parts go first. Enumerating, the covers
+// of all parts but the largest are collected, then each cover of the largest
+// is shown with every combination of them, as it is found. Parts split
+// further down the same way, a pruner sees the columns of one part.
+// True if the open columns fell apart and the split searched them.
+template<class TI>
+bool DIX<TI>::Split(vector<TI>& soln)
+{
+	const vector<vector<TI>> parts(Parts());
+	if (parts.size() < 2) { return false; }
+	vector<TI> open;
+	for (TI c(_head[0].R); c; c = _head[c].R) { open.emplace_back(c); }
+
+	if (!_show) {
+		const Count before(found);
+		Count product(1);
+		++_apart;
+		for (const auto& p : parts) {
+			Link(p);
+			found = 0;
+			Branch(soln, true);
+			product *= found;
+			if (!product || Stopped()) { break; }
+		}
+		--_apart;
+		Link(open);
+		found = before;
+		if (product && !Stopped()) { // a stopped part's count is partial
+			found += product;
+			Notify();
+		}
+		return true;
+	}
+
+	const size_t collect(_collect), from(_collectFrom), base(_partsBase), mark(_parts.size());
+	bool covered(true);
+	_collectFrom = soln.size();
+	for (size_t k(0); covered && k + 1 < parts.size(); ++k) {
+		_parts.emplace_back();
+		_partsBase = _parts.size(); // parts collected already combine with the last one only
+		_collect = _parts.size() - 1; // an index, splits below add to _parts
+		Link(parts[k]);
+		Branch(soln, true);
+		covered = !_parts[_collect].empty() && !Stopped();
+	}
+	_collect = collect;
+	_collectFrom = from;
+	_partsBase = base;
+	if (covered) {
+		Link(parts.back());
+		Branch(soln, true);
+	}
+	_parts.resize(mark);
+	Link(open);
+	return true;
+}
+
+// open columns grouped by the live rows joining them, ascending size; one
+// part: empty. Each live row is visited once at most, a connected search
+// stops as soon as the first part reaches every open column.
+template<class TI>
+vector<vector<TI>> DIX<TI>::Parts()
+{
+	if (_reached.empty()) {
+		_reached.resize(_head.size());
+		_visited.resize(_sep.size());
+	}
+	++_pass;
+	size_t left(0);
+	for (TI c(_head[0].R); c; c = _head[c].R) { ++left; }
+	vector<vector<TI>> parts;
+	for (TI first(_head[0].R); first; first = _head[first].R) {
+		if (_pass == _reached[first]) { continue; } // in a part already
+		parts.emplace_back(1, first);
+		--left;
+		_reached[first] = _pass;
+		_queue.assign(1, first);
+		while (!_queue.empty()) {
+			const TI c(_queue.back());
+			_queue.pop_back();
+			for (TI i(_tile[c].D); i != c; i = _tile[i].D) {
+				TI j(i);
+				for (; _tile[j - 1].C; --j) {}
+				const TI row(_tile[j - 1].U);
+				if (_pass == _visited[row]) { continue; }
+				_visited[row] = _pass;
+				for (; _tile[j].C; ++j) {
+					const TI k(_tile[j].C);
+					if (_pass == _reached[k]) { continue; }
+					_reached[k] = _pass;
+					_queue.emplace_back(k);
+					if (k > _pc) { continue; } // secondary columns join parts, they are not part of one
+					parts.back().emplace_back(k);
+					if (!--left && 1 == parts.size()) { return vector<vector<TI>>(); } // connected
+				}
+			}
+		}
+	}
+	stable_sort(parts.begin(), parts.end(), [](const vector<TI>& a, const vector<TI>& b) { return a.size() < b.size(); });
+	return parts;
+}
+
+// the head list holds just these columns, in this order
+template<class TI>
+void DIX<TI>::Link(const vector<TI>& cols)
+{
+	TI prev(0);
+	for (const auto& c : cols) {
+		_head[prev].R = c;
+		_head[c].L = prev;
+		prev = c;
+	}
+	_head[prev].R = 0;
+	_head[0].L = prev;
+}
+
+// enumerating, the open columns are covered: combine with a cover of each
+// collected part from this one on, the result goes to the part being
+// collected, or is a solution
+template<class TI>
+void DIX<TI>::Covered(vector<TI>& soln, const size_t part)
+{
+	if (part < _parts.size()) {
+		for (const auto& p : _parts[part]) {
+			soln.insert(soln.end(), p.begin(), p.end());
+			Covered(soln, part + 1);
+			soln.resize(soln.size() - p.size());
+			if (Stopped()) { return; }
+		}
+		return;
+	}
+	if (NONE != _collect) {
+		_parts[_collect].emplace_back(soln.begin() + _collectFrom, soln.end());
+		return;
+	}
+	++found;
+	_notify(Event::Soln);
+	ShowSoln(soln);
+}
+
+// ---------- propagation ----------
+
+// Reduce the problem after a choice without creating branch points: a column
+// with a single row left forces that row, a column with no rows left fails
+// the branch wherever it is in the list. Propagate::Rows also removes rows
+// that would leave some other primary column without rows. Every step goes
+// on the trail, Unpropagate takes them back in reverse order.
+template<class TI>
+bool DIX<TI>::Propagated(vector<TI>& soln)
+{
+	for (bool again(true); again;) {
+		for (TI c(_head[0].R); c;) {
+			if (!_head[c].N) { return false; } // dead column
+			if (1 == _head[c].N) { // forced row
+				const TI i(_tile[c].D);
+				soln.emplace_back(i);
+				ChooseRow(i);
+				if (cheapest) { _spent += RowCost(i); }
+				_trail.push_back({ i, true });
+				c = _head[0].R; // list changed, rescan
+				continue;
+			}
+			c = _head[c].R;
+		}
+		again = Propagate::Rows == propagate && PruneRows();
+	}
+	return true;
+}
+
+template<class TI>
+bool DIX<TI>::PruneRows()
+{
+	if (_look.seen.empty()) { // first use
+		_look.mine.resize(_head.size());
+		_look.counted.resize(_head.size());
+		_look.count.resize(_head.size());
+		_look.hit.resize(_sep.size());
+		_look.seen.resize(_sep.size());
+	}
+	++_look.pass;
+	bool pruned(false);
+	for (TI c(_head[0].R); c; c = _head[c].R) {
+		for (TI i(_tile[c].D); i != c; i = _tile[i].D) { // a removed tile keeps its links, so iteration goes on
+			TI sep(i);
+			for (; _tile[sep].C; --sep) {}
+			const TI row(_tile[sep].U);
+			if (_look.pass == _look.seen[row]) { continue; } // tested from another column
+			_look.seen[row] = _look.pass;
+			if (Hopeless(sep + 1)) {
+				RemoveRow(sep + 1);
+				_trail.push_back({ TI(sep + 1), false });
+				pruned = true;
+			}
+		}
+	}
+	return pruned;
+}
+
+// true if taking the row would leave a primary column with no rows
+template<class TI>
+bool DIX<TI>::Hopeless(const TI first)
+{
+	const auto eval(++_look.eval);
+	for (TI j(first); _tile[j].C; ++j) { _look.mine[_tile[j].C] = eval; }
+	for (TI j(first); _tile[j].C; ++j) {
+		for (TI k(_tile[j].D); k != j; k = _tile[k].D) { // other rows in the column, each leaves with the tested row
+			if (k == _tile[j].C) { continue; } // column tile
+			TI sep(k);
+			for (; _tile[sep].C; --sep) {}
+			if (eval == _look.hit[_tile[sep].U]) { continue; } // already met in another column
+			_look.hit[_tile[sep].U] = eval;
+			for (TI m(sep + 1); _tile[m].C; ++m) {
+				const TI y(_tile[m].C);
+				if (eval == _look.mine[y]) { continue; } // covered by the tested row
+				if (eval != _look.counted[y]) { _look.counted[y] = eval; _look.count[y] = _head[y].N; }
+				if (!--_look.count[y] && y <= _pc) { return true; }
+			}
+		}
+	}
+	return false;
+}
+
+template<class TI>
+void DIX<TI>::Unpropagate(const size_t mark, vector<TI>& soln)
+{
+	for (; _trail.size() > mark; _trail.pop_back()) {
+		if (_trail.back().forced) {
+			if (cheapest) { _spent -= RowCost(_trail.back().i); }
+			UnchooseRow(_trail.back().i);
+			soln.pop_back();
+		}
+		else { RestoreRow(_trail.back().i); }
+	}
+}
+
+// ---------- row operations ----------
+
+// take the row of tile i as Search does: its column, then the nodes to the left, then to the right
+template<class TI>
+void DIX<TI>::ChooseRow(const TI i)
+{
+	Cover(_tile[i].C);
+	for (TI j(i - 1); _tile[j].C; --j) { Cover(_tile[j].C); }
+	for (TI j(i + 1); _tile[j].C; ++j) { Cover(_tile[j].C); }
+}
+
+template<class TI>
+void DIX<TI>::UnchooseRow(const TI i)
+{
+	TI jR(i), jL(i);
+	for (; _tile[jR + 1].C; ++jR) {}
+	for (; _tile[jL - 1].C; --jL) {}
+	for (TI j(jR); j != i; --j) { Uncover(_tile[j].C); }
+	for (TI j(jL); j != i; ++j) { Uncover(_tile[j].C); }
+	Uncover(_tile[i].C);
 }
 
-void DIX::CoverNode(const TI& c)
+// take a row out of its columns without covering them
+template<class TI>
+void DIX<TI>::RemoveRow(const TI first)
+{
+	for (TI j(first); _tile[j].C; ++j) { CoverNode(j); }
+}
+
+template<class TI>
+void DIX<TI>::RestoreRow(const TI first)
+{
+	TI j(first);
+	for (; _tile[j + 1].C; ++j) {} // last node of row
+	for (; j >= first; --j) { UncoverNode(j); }
+}
+
+// ---------- assumptions ----------
+
+// A forbidden row has its nodes taken out of their columns, as Cover does for
+// the tiles of a covered column. A required row is chosen as Search chooses
+// one, by covering all its columns; a required row that is forbidden or shares
+// a column with an earlier required row leaves nothing to search.
+template<class TI>
+bool DIX<TI>::Assume(const Soln& require, const Soln& forbid, vector<TI>& soln, vector<TI>& removed)
+{
+	for (const auto& r : require) { if (r >= _sep.size()) { throw(runtime_error("required row out of range")); } }
+	for (const auto& r : forbid) { if (r >= _sep.size()) { throw(runtime_error("forbidden row out of range")); } }
+
+	vector<bool> out(_sep.size(), false);
+	for (const auto& f : forbid) {
+		if (out[f]) { continue; } // removing twice would break the links
+		out[f] = true;
+		RemoveRow(_sep[f] + 1);
+		removed.emplace_back(_sep[f]);
+	}
+
+	vector<bool> in(_sep.size(), false);
+	vector<bool> covered(_head.size(), false);
+	for (const auto& q : require) {
+		if (in[q]) { continue; } // already chosen
+		in[q] = true;
+		if (out[q]) { return false; } // required and forbidden
+		for (TI j(_sep[q] + 1); _tile[j].C; ++j) {
+			if (covered[_tile[j].C]) { return false; } // conflicts with earlier required row
+		}
+		for (TI j(_sep[q] + 1); _tile[j].C; ++j) { covered[_tile[j].C] = true; }
+		soln.emplace_back(_sep[q] + 1);
+		ChooseRow(_sep[q] + 1);
+	}
+	return true;
+}
+
+template<class TI>
+void DIX<TI>::Unassume(vector<TI>& soln, vector<TI>& removed)
+{
+	for (; !soln.empty(); soln.pop_back()) { UnchooseRow(soln.back()); } // required rows, reverse order
+	for (; !removed.empty(); removed.pop_back()) { RestoreRow(removed.back() + 1); } // forbidden rows, reverse order
+}
+
+template<class TI>
+void DIX<TI>::CoverNode(const TI& c)
 {
 	--_head[_tile[c].C].N; // inform column head that it has one less node
 	_tile[  _tile[c].D].U = _tile[c].U; // remove node from column
 	_tile[  _tile[c].U].D = _tile[c].D;
 }
 
-void DIX::UncoverNode(const TI& c)
+template<class TI>
+void DIX<TI>::UncoverNode(const TI& c)
 {
 	++_head[_tile[c].C].N; // inform column head that node came back
 	_tile[  _tile[c].D].U = c; // insert node back into column
 	_tile[  _tile[c].U].D = c;
 }
 
-void DIX::Cover(const TI& c) // remove all tiles covering node, remove node
+template<class TI>
+void DIX<TI>::Cover(const TI& c) // remove all tiles covering node, remove node
 {
 	// remove self from head node list
 	_head[_head[c].R].L = _head[c].L;
@@ -174,7 +649,8 @@ void DIX::Cover(const TI& c) // remove all tiles covering node, remove node
 	}
 }
 
-void DIX::Uncover(const TI& c)
+template<class TI>
+void DIX<TI>::Uncover(const TI& c)
 {
 	// reinsert self into head node list
 	_head[_head[c].R].L = c;
@@ -191,7 +667,8 @@ void DIX::Uncover(const TI& c)
 	}
 }
 
-DIX::TI DIX::ChooseColumn() const
+template<class TI>
+TI DIX<TI>::ChooseColumn() const
 {
 	// minimize search space by selecting most constrained column
 	TI iMin(0); // head node: N == numeric_limits<TI>::max()
@@ -202,16 +679,23 @@ DIX::TI DIX::ChooseColumn() const
 	return iMin;
 }
 
-void DIX::ShowSoln(const vector<TI>& soln)const
+template<class TI>
+TI DIX<TI>::RowOf(const TI i) const
 {
-	cout << "[\n";
-	for (const auto& i : soln) { // a single node in a tile
-		TI iFirst(i);
-		for (; _tile[iFirst-1].C; --iFirst) {} // search left for first node in tile
-		for (TI j(iFirst); _tile[j].C; ++j) {
-			cout << _tile[j].C-1 << " "; // internal column is 1 based, external representation is 0 based
-		}
-		cout << "\n";
-	}
-	cout << "]\n";
+	TI iSep(i);
+	for (; _tile[iSep].C; --iSep) {} // search left for separator before tile
+	return _tile[iSep].U; // separator holds input row number
 }
+
+template<class TI>
+void DIX<TI>::ShowSoln(const vector<TI>& soln)const
+{
+	Soln rows;
+	for (const auto& i : soln) { rows.emplace_back(RowOf(i)); } // a single node in a tile
+	_show(rows);
+}
+
+// index types, see dix.h
+template class DIX<uint16_t>;
+template class DIX<uint32_t>;
+template class DIX<uint64_t>;
@@ -1,10 +1,15 @@
 // modified dancing links solver implementation: dancing indices, use vector index instead of node pointer
 // Bill Ola Rasmussen
 #include "Solver.h"
+#include "ProblemMatrix.h"
+#include "Endgame.h"
 #include <vector>
+#include <cstdint>
 
+// TI: index type, instantiated for uint16_t, uint32_t and uint64_t. The
+// narrowest type holding MaxIndex() halves the structure for small problems.
+template<class TI>
 class DIX : public Solver {
-	using TI = unsigned int; // index type
 	struct HeadNode { 
 		TI L, R, N;  // column to left, column to right, count of nodes covering column
 		bool operator==(const HeadNode&rhs)const{return rhs.L==L && rhs.R==R && rhs.N==N;} // used in integrity check
@@ -13,25 +18,74 @@ class DIX : public Solver {
 		TI U, D, C; // row up, row down, column covered by the node: index starting at 1 to match HeadNode vector
 		bool operator==(const TileNode&rhs)const{return rhs.U==U && rhs.D==D && rhs.C==C;} // used in integrity check
 	};
-	const static TileNode SEP; // tile separator
+	const static TileNode SEP; // tile separator, the separator before a tile holds the tile's input row number in U
 	std::vector<HeadNode> _head;
 	std::vector<TileNode> _tile; // key concept: at solve time, the relationship between tile nodes is static
-	bool _show;
+	std::vector<TI> _sep; // index of the separator before each input row's tile, used to apply assumptions
+	TI _pc; // primary constraint count, head indices 1 to _pc
+	struct Step { TI i; bool forced; }; // propagation trail: tile of a forced row taken, or first tile of a pruned row
+	std::vector<Step> _trail;
+	struct Lookahead { // Propagate::Rows scratch, stamped so nothing is cleared between uses
+		std::vector<unsigned long long> mine, counted, hit, seen; // stamps: column in tested row, count valid, row met, row tested this pass
+		std::vector<TI> count; // column sizes left if the tested row were taken
+		unsigned long long eval = 0, pass = 0;
+	} _look;
+	std::vector<unsigned int> _open; // primary columns passed to prune
+	std::vector<ProblemMatrix::Cost> _cost; // of each input row, empty without costs
+	std::vector<double> _share; // of each tile: its row's cost spread evenly over the row's primary columns
+	ProblemMatrix::Cost _spent; // cost of the rows in the partial solution
+	struct Best { ProblemMatrix::Cost cost; Soln rows; };
+	std::vector<Best> _best; // cheapest covers so far, ascending cost, at most cheapest of them
+	Endgame _end;
+	std::size_t _widest; // most primary columns in a row, bounds the residual row count from below
+	Show _show;
 	std::function<void(Event)> _notify;
-	void ShrinkToFit(); // optional optimization
+	// split: the open columns fall apart into parts sharing no live rows, see Split
+	std::size_t _level; // branching depth
+	std::vector<unsigned long long> _reached, _visited; // stamps: column reached, input row visited, in the current pass
+	unsigned long long _pass = 0;
+	std::vector<TI> _queue; // columns reached, their rows not visited yet
+	unsigned int _apart; // counting: part searches running, found holds the count of the innermost part
+	std::vector<std::vector<std::vector<TI>>> _parts; // enumerating: covers collected of parts split off, each one combined with every cover found below
+	std::size_t _partsBase; // _parts from here on combine with the covers found now, the ones before belong to an outer split
+	std::size_t _collect; // in _parts, covers of the part being collected, NONE when covers are solutions
+	static const std::size_t NONE = std::size_t(-1);
+	std::size_t _collectFrom; // soln size where the part being collected begins
+	unsigned long long Sum() const; // checksum of all link fields
 	void Search(std::vector<TI>& soln);
+	void Branch(std::vector<TI>& soln, const bool connected = false);
+	bool Split(std::vector<TI>& soln);
+	std::vector<std::vector<TI>> Parts();
+	void Link(const std::vector<TI>& cols);
+	void Covered(std::vector<TI>& soln, const std::size_t part);
+	void Notify() { if (!_apart) { _notify(Event::Soln); } }
+	bool Pruned();
+	bool Bounded() const;
+	void Record(const std::vector<TI>& soln);
+	bool Finished(std::vector<TI>& soln);
+	bool Propagated(std::vector<TI>& soln);
+	bool PruneRows();
+	bool Hopeless(const TI first);
+	void Unpropagate(const std::size_t mark, std::vector<TI>& soln);
+	void ChooseRow(const TI i);
+	void UnchooseRow(const TI i);
+	void RemoveRow(const TI first);
+	void RestoreRow(const TI first);
 	void CoverNode(const TI& c);
 	void UncoverNode(const TI& c);
 	void Cover(const TI& c);
 	void Uncover(const TI& c);
 	TI ChooseColumn()const;
+	TI RowOf(const TI i) const; // input row of tile i
+	ProblemMatrix::Cost RowCost(const TI i) const { return _cost[RowOf(i)]; }
 	void ShowSoln(const std::vector<TI>& soln)const;
+	bool Assume(const Soln& require, const Soln& forbid, std::vector<TI>& soln, std::vector<TI>& removed);
+	void Unassume(std::vector<TI>& soln, std::vector<TI>& removed);
 public:
-	DIX(){}
-	void Init(const unsigned int pc, const unsigned int sc) override;
-	void Row(const unsigned int col) override;
-	void Col(const unsigned int col) override;
-	void Solve(const bool showSoln, std::function<void(Event)>CallBack) override;
+	explicit DIX(const ProblemMatrix& pm);
+	static std::size_t MaxIndex(const ProblemMatrix& pm) { return 1+pm.Cols()+1+pm.Nodes()+pm.Rows(); } // tile count, max is the separator
+	void Solve(Show ShowSoln, std::function<void(Event)>CallBack) override;
+	void SolveAssuming(const Soln& require, const Soln& forbid, Show ShowSoln, std::function<void(Event)>CallBack) override;
 	DIX&operator=(const DIX&)=delete; // no assignment
 	DIX(const DIX&)=delete; // no copy constructor
 };
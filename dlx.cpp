@@ -9,6 +9,7 @@
 #include <stdexcept>
 #include <memory>
 #include <limits>
+#include <algorithm>
 using namespace std;
 
 // note: comments marked with '|' indicate text from the paper
@@ -35,36 +36,55 @@ Node*HeadNode::LinkU(Node*p) // place node in same column before this item
 HeadNode*RaiiNodes::GetHead(int col) // col is -1 for header head
 {
 	// verification overhead, do not use at solve time
-	if((int)v.size()-1<col+1){throw(runtime_error("GetHead index out of range"));}
-	auto ph(dynamic_cast<HeadNode*>(v[col+1].get()));
-	if(!ph){throw(runtime_error("failed HeadNode dynamic cast"));}
+	if((int)vh.size()-1<col+1){throw(runtime_error("GetHead index out of range"));}
+	HeadNode*ph(&vh[col+1]);
 	if(col!=ph->N){throw(runtime_error("bad Head node name"));}
 	return ph;
 }
 
-vector<std::unique_ptr<Node>>RaiiNodes::Snap()const
+RaiiNodes::RaiiNodes(const ProblemMatrix&pm):vh(1+pm.Cols()),v(pm.Nodes()),first(pm.Rows()) // final sizes, node addresses are stable
 {
-	vector<unique_ptr<Node>> x;
-	for(const auto&i:v)
+	for(size_t i(0);i<vh.size();++i) // all head nodes get a name, header head is -1
 	{
-		x.emplace_back(i.get()->Clone());
+		vh[i].N=i-1;
 	}
-	return x;
-}
-
-//#include <typeinfo>
-bool RaiiNodes::Comp(vector<std::unique_ptr<Node>>&x)const
-{
-	if(x.size()!=v.size()){return false;}
-	for(size_t i(0);i<x.size();++i)
+	for(unsigned int i(1);i<=pm.Primary();++i) // primary constraint head nodes
+	{
+		vh[0].LinkL(&vh[i]);
+	}
+	// secondary constraint head nodes: no link to peers
+	Node*p(v.data());
+	for(unsigned int r(0);r<pm.Rows();++r)
 	{
-		//cout<<"types: "<<typeid(*x[i].get()).name()<<" "<<typeid(*v[i].get()).name()<<"\n";
-		if(!x[i].get()->Same(v[i].get()))
+		first[r]=p-v.data();
+		auto col(pm.RowBegin(r));
+		Node*rowStart(vh[*col+1].LinkU(p++));
+		for(++col;col!=pm.RowEnd(r);++col)
 		{
-			return false;
+			rowStart->LinkL(vh[*col+1].LinkU(p++));
 		}
 	}
-	return true;
+}
+
+unsigned int RaiiNodes::Row(const Node*p)const
+{
+	// rows are in order in the arena: last row starting at or before the node
+	return upper_bound(first.begin(),first.end(),size_t(p-v.data()))-first.begin()-1;
+}
+
+static CheckSum&AddLinks(CheckSum&s,const Node&n)
+{
+	return s.Add(reinterpret_cast<unsigned long long>(n.L)).Add(reinterpret_cast<unsigned long long>(n.R))
+		.Add(reinterpret_cast<unsigned long long>(n.U)).Add(reinterpret_cast<unsigned long long>(n.D))
+		.Add(reinterpret_cast<unsigned long long>(n.C));
+}
+
+unsigned long long RaiiNodes::Sum()const
+{
+	CheckSum s;
+	for(const auto&h:vh){AddLinks(s,h).Add(h.S).Add(h.N);}
+	for(const auto&i:v){AddLinks(s,i);}
+	return s.Value();
 }
 
 // Generalized Exact Cover
@@ -81,28 +101,7 @@ bool RaiiNodes::Comp(vector<std::unique_ptr<Node>>&x)const
 // | secondary column should have L and R fields that simply point to itself. The remainder
 // | of the algorithm proceeds exactly as before, so we will still call it algorithm DLX.
 //
-// see insertion of secondary constraint head nodes below
-
-void DLX::Init(const unsigned int pc, const unsigned int sc)
-{
-	n.V(new HeadNode(-1)); // head node of head nodes
-	for(unsigned int i(0);i<pc;++i) // primary constraint head nodes
-	{
-		n.V(n.GetHead(-1)->LinkL(new HeadNode(i))); // link on raw pointers
-	}
-	for(unsigned int i(0);i<sc;++i) // secondary constraint head nodes
-	{
-		n.V(new HeadNode(i+pc)); // no link to peers
-	}
-}
-void DLX::Row(const unsigned int col)
-{
-	n.V(rowStart=n.GetHead(col)->LinkU(new Node()));
-}
-void DLX::Col(const unsigned int col)
-{    
-	n.V(rowStart->LinkL(n.GetHead(col)->LinkU(new Node())));
-}
+// see insertion of secondary constraint head nodes in RaiiNodes constructor
 
 // Knuth's Algorithm X
 // -------------------
@@ -116,23 +115,26 @@ void DLX::Col(const unsigned int col)
 // |             delete row i from matrix A.
 // | Repeat this algorithm recursively on the reduced matrix A.
 
-void DLX::Solve(const bool showSoln, std::function<void(Event)>CallBack)
+void DLX::Solve(Show ShowSoln, std::function<void(Event)>CallBack)
 {
-	show=showSoln;
+	show=ShowSoln;
 	Notify = CallBack;
 
-	cout<<"DLX::Solve with "<<n.Size()<<" nodes\n";
+	*out<<"DLX::Solve with "<<n.Size()<<" nodes\n";
 	
-	vector<unique_ptr<Node>>x(n.Snap()); // capture start state
-	if(!n.Comp(x)){throw(runtime_error("early node structure integrity failure"));}
+	// capture start state, only as much as the check mode needs
+	const unsigned long long sum(Check::Sum==check?n.Sum():0);
+	const RaiiNodes::Snapshot x(Check::Full==check?n.Snap():RaiiNodes::Snapshot());
 	
 	vector<Node*>O;
+	found=0;
 	Notify(Event::Begin);
 	Search(n.GetHead(-1),0,O);
 	Notify(Event::End);
 
-	if(!n.Comp(x)){throw(runtime_error("node structure integrity failure"));}
-	cout<<"Node structure integrity verified.\n";
+	if(Check::Sum==check&&sum!=n.Sum()){throw(runtime_error("node structure checksum failure"));}
+	if(Check::Full==check&&!n.Comp(x)){throw(runtime_error("node structure integrity failure"));}
+	if(Check::Off!=check){*out<<"Node structure integrity verified.\n";}
 }
 
 // Algorithm Details
@@ -161,6 +163,7 @@ void DLX::Search(HeadNode*h,int k,vector<Node*>&O)
 {
 	if(h==h->R) // no head nodes
 	{
+		++found;
 		Notify(Event::Soln);
 		if(show){ShowSolution(k,O);}
 		return;
@@ -194,6 +197,7 @@ void DLX::Search(HeadNode*h,int k,vector<Node*>&O)
 		{
 			Uncover(j->C);
 		}        
+		if(Stopped()){break;}
 	}
 	Uncover(c);
 }
@@ -201,22 +205,17 @@ void DLX::Search(HeadNode*h,int k,vector<Node*>&O)
 // | The operation of printing the current solution is easy: We successively print the rows
 // | containing O sub 0, O sub 1, ..., O sub k−1 , where the row containing data object O is
 // | printed by printing N[C[O]], N[C[R[O]]], N[C[R[R[O]]]], etc.
+//
+// Here the rows are reported by input row number, the caller prints them.
 
 void DLX::ShowSolution(int /*k*/,std::vector<Node*>&O)const
 {
-	cout<<"[\n";
-	
+	Soln soln;
 	for(const auto& r:O)
 	{
-		cout<<r->C->N<<" ";
-		for(Node*j=r->R;j!=r;j=j->R) // all the nodes in row
-		{
-			cout<<j->C->N<<" ";
-		}
-		cout<<"\n";
+		soln.emplace_back(n.Row(r));
 	}
-	
-	cout<<"]\n";
+	show(soln);
 }
 
 // Minimize Search Branching Factor
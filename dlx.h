@@ -1,9 +1,9 @@
 // dlx solver interface
 // Bill Ola Rasmussen
 #include "Solver.h"
+#include "ProblemMatrix.h"
 #include <vector>
 #include <iostream>
-#include <memory>
 
 // note: comments marked with '|' indicate text from the paper
 // http://www-cs-faculty.stanford.edu/~uno/papers/dancing-color.ps.gz
@@ -30,64 +30,54 @@ class Node {
 public:
 	Node*L,*R,*U,*D; // left, right, up, down
 	HeadNode*C; // head
-	Node():L(this),R(this),U(this),D(this),C(nullptr){/*std::cout<<"Node "<<this<<"\n";*/}
-	virtual ~Node(){/*std::cout<<"~Node "<<this<<"\n";*/}
+	Node():L(this),R(this),U(this),D(this),C(nullptr){}
 	Node*LinkL(Node*p);
 	// node integrity test support
-	virtual std::unique_ptr<Node>Clone()const{return std::unique_ptr<Node>(new Node(*this));}
-	virtual bool Same(const Node*const n)const
-	{
-		//std::cout<<" node comp\n";
-		return L==n->L&&R==n->R&&U==n->U&&D==n->D&&C==n->C;
-	}
+	bool operator==(const Node&n)const{return L==n.L&&R==n.R&&U==n.U&&D==n.D&&C==n.C;}
 };
 
 class HeadNode : public Node {
 public:
 	int S,N; // size, name
-	HeadNode(int name):S(0),N(name){/*std::cout<<"Head Node "<<this<<"\n";*/}
-	virtual ~HeadNode(){/*std::cout<<"~HeadNode "<<this<<"\n";*/}
+	HeadNode():S(0),N(0){}
 	Node*LinkU(Node*p);
 	// node integrity test support
-	std::unique_ptr<Node>Clone()const override{return std::unique_ptr<HeadNode>(new HeadNode(*this));}
-	bool Same(const Node*const n)const override// must have same signature, so casting later on...
-	{
-		//std::cout<<" HeadNode comp";
-		const auto h(dynamic_cast<const HeadNode*const>(n));
-		return h&&Node::Same(n)&&S==h->S&&N==h->N;
-	}
+	bool operator==(const HeadNode&h)const{return Node::operator==(h)&&S==h.S&&N==h.N;}
 };
 
-// The implementation of the algorithm uses raw pointers. Node lifetime
-// is managed by unique_ptr vector.
+// The implementation of the algorithm uses raw pointers. Nodes are plain
+// structs without virtual functions, allocated from two contiguous arenas:
+// one for head nodes and one for all other nodes in row-major order. Both
+// arenas are sized from the problem matrix up front and linked in one pass.
 
 class RaiiNodes {
-	std::vector<std::unique_ptr<Node>>v;
+	std::vector<HeadNode>vh; // head node of head nodes, then one head node per column
+	std::vector<Node>v; // all other nodes, the nodes of a row are adjacent
+	std::vector<std::size_t>first; // index into v of the first node of each row
 public:
-	void V(Node*p){v.emplace_back(std::unique_ptr<Node>(p));}
+	explicit RaiiNodes(const ProblemMatrix&pm);
 	HeadNode*GetHead(int col); // col is -1 for header head
-	size_t Size()const{return v.size();}
+	std::size_t Size()const{return vh.size()+v.size();}
+	unsigned int Row(const Node*p)const; // input row number of a node
 	// node integrity test support
-	std::vector<std::unique_ptr<Node>> Snap()const;
-	bool Comp(std::vector<std::unique_ptr<Node>>&x)const;
+	struct Snapshot{std::vector<HeadNode>vh;std::vector<Node>v;};
+	Snapshot Snap()const{return Snapshot{vh,v};}
+	bool Comp(const Snapshot&x)const{return x.vh==vh&&x.v==v;}
+	unsigned long long Sum()const; // checksum of all link fields
 };
 
 class DLX:public Solver{
 	RaiiNodes n; // allocation bucket
-	Node*rowStart;
 	std::function<void(Event)>Notify;
-	bool show;
+	Show show;
 	void Search(HeadNode*h,int k,std::vector<Node*>&O);
 	void ShowSolution(int k,std::vector<Node*>&O)const;
 	HeadNode*ChooseColumn(HeadNode*hh)const;
 	void Cover(HeadNode*c);
 	void Uncover(HeadNode*c);
 public:
-	DLX(){} // should not need to define this?
-	void Init(const unsigned int pc, const unsigned int sc) override;
-	void Row(const unsigned int col) override;
-	void Col(const unsigned int col) override;
-	void Solve(const bool showSoln, std::function<void(Event)>CallBack) override;
+	explicit DLX(const ProblemMatrix&pm):n(pm){}
+	void Solve(Show ShowSoln, std::function<void(Event)>CallBack) override;
 	DLX&operator=(const DLX&)=delete; // no assignment
 	DLX(const DLX&)=delete; // no copy constructor
 };
@@ -3,10 +3,22 @@
 
 #include "dlx2.h"
 #include <stdexcept>
-#include <memory>
 #include <iostream>
+#include <algorithm>
+#ifdef _MSC_VER
+#include <xmmintrin.h>
+#endif
 using namespace std;
 
+static inline void Prefetch(const void*p) // hint: load into cache, no fault on any address
+{
+#ifdef _MSC_VER
+	_mm_prefetch(static_cast<const char*>(p),_MM_HINT_T0);
+#else
+	__builtin_prefetch(p);
+#endif
+}
+
 Node2*Node2::LinkL(Node2*p) // place node in same row before this item
 {
 	p->R=this; p->L=L;
@@ -22,27 +34,25 @@ Node2*HeadNode2::LinkU(Node2*p) // place node in same column before this item
 	return p;    
 }
 
-vector<std::unique_ptr<Node2>>RaiiNodes2::Snap()const
+static CheckSum&AddLinks(CheckSum&s,const Node2&n)
 {
-	vector<unique_ptr<Node2>> x;
-	for(const auto&i:v)
-	{
-		x.emplace_back(i.get()->Clone());
-	}
-	return x;
+	return s.Add(reinterpret_cast<unsigned long long>(n.L)).Add(reinterpret_cast<unsigned long long>(n.R))
+		.Add(reinterpret_cast<unsigned long long>(n.U)).Add(reinterpret_cast<unsigned long long>(n.D))
+		.Add(reinterpret_cast<unsigned long long>(n.C));
 }
 
-bool RaiiNodes2::Comp(vector<std::unique_ptr<Node2>>&x)const
+unsigned long long RaiiNodes2::Sum()const
 {
-	if(x.size()!=v.size()){return false;}
-	for(size_t i(0);i<x.size();++i)
-	{
-		if(!x[i].get()->Same(v[i].get()))
-		{
-			return false;
-		}
-	}
-	return true;
+	CheckSum s;
+	for(const auto&h:vh){AddLinks(s,h).Add(h.S).Add(h.N);}
+	for(const auto&i:v){AddLinks(s,i);}
+	return s.Value();
+}
+
+unsigned int RaiiNodes2::Row(const Node2*p)const
+{
+	// rows are in order in the arena: last row starting at or before the node
+	return upper_bound(first.begin(), first.end(), size_t(p - v.data())) - first.begin() - 1;
 }
 
 HeadNode2*RaiiNodes2::GetHead(int col) // col is -1 for header head
@@ -59,66 +69,452 @@ HeadNode2*RaiiNodes2::GetHead(int col) // col is -1 for header head
 }
 
 // contiguous head array to increase locality of reference
-void DLX2::Init(const unsigned int pc, const unsigned int sc)
+// contiguous nodes in tiles
+RaiiNodes2::RaiiNodes2(const ProblemMatrix&pm) : vh(1 + pm.Cols()), v(pm.Nodes()), first(pm.Rows()), pc(pm.Primary()) // final sizes, node addresses are stable
 {
-	n.vh.resize(1 + pc + sc); // head node of head nodes, primary constraints, secondary constraints
-	for (vector<HeadNode2>::size_type i(0); i < n.vh.size(); ++i) // all nodes get a name, hh == -1
+	for (vector<HeadNode2>::size_type i(0); i < vh.size(); ++i) // all nodes get a name, hh == -1
 	{
-		n.vh[i].N = i - 1;
+		vh[i].N = i - 1;
 	}
-	for (unsigned int i(1); i < pc; ++i) // circular link primary constraint nodes
+	for (unsigned int i(1); i <= pm.Primary(); ++i) // circular link primary constraint nodes
 	{
-		n.GetHead(-1)->LinkL(&n.vh[i]);
+		vh[0].LinkL(&vh[i]);
+	}
+	Node2*p(v.data());
+	for (unsigned int r(0); r < pm.Rows(); ++r)
+	{
+		first[r] = p - v.data();
+		auto col(pm.RowBegin(r));
+		Node2*rowStart(vh[*col + 1].LinkU(p++));
+		for (++col; col != pm.RowEnd(r); ++col)
+		{
+			rowStart->LinkL(vh[*col + 1].LinkU(p++));
+		}
 	}
 }
-// 2. todo: make contiguous nodes in tiles
-void DLX2::Row(const unsigned int col)
+
+void DLX2::Solve(Show ShowSoln, std::function<void(Event)>CallBack)
 {
-	n.V(rowStart=n.GetHead(col)->LinkU(new Node2()));
-}
-void DLX2::Col(const unsigned int col)
-{    
-	n.V(rowStart->LinkL(n.GetHead(col)->LinkU(new Node2())));
+	SolveAssuming(Soln(), Soln(), ShowSoln, CallBack);
 }
 
-void DLX2::Solve(const bool showSoln, std::function<void(Event)>CallBack)
+void DLX2::SolveAssuming(const Soln&require, const Soln&forbid, Show ShowSoln, std::function<void(Event)>CallBack)
 {
-	show=showSoln;
+	show=ShowSoln;
 	Notify = CallBack;
 
-	cout<<"DLX2::Solve with "<<n.vh.size()-1<<" head nodes, " << n.v.size() << " nodes\n";
+	*out<<"DLX2::Solve with "<<n.vh.size()-1<<" head nodes, " << n.v.size() << " nodes\n";
 	
-	vector<unique_ptr<Node2>>x(n.Snap()); // capture start state
-	if(!n.Comp(x)){throw(runtime_error("early node structure integrity failure"));}
+	// capture start state, only as much as the check mode needs
+	const unsigned long long sum(Check::Sum==check?n.Sum():0);
+	const RaiiNodes2::Snapshot x(Check::Full==check?n.Snap():RaiiNodes2::Snapshot());
 	
-	vector<Node2*>Soln;
+	found=0;
 	Notify(Event::Begin);
-	Search(n.GetHead(-1),Soln);
+	auto range(Solutions(require,forbid));
+	cur.bulk=!show;
+	for(const auto&soln:range)
+	{
+		found+=cur.leaf;
+		Notify(Event::Soln);
+		if(show){ShowSolution(soln.Nodes());}
+	}
 	Notify(Event::End);
+	if(Check::Sum==check&&sum!=n.Sum()){throw(runtime_error("node structure checksum failure"));}
+	if(Check::Full==check&&!n.Comp(x)){throw(runtime_error("node structure integrity failure"));}
+	if(Check::Off!=check){*out<<"Node2 structure integrity verified.\n";}
+}
+
+// Assumptions
+// -----------
+// A forbidden row is unlinked from all its columns, as Cover does with the
+// rows of a covered column. A required row is chosen as the search would
+// choose it: all its columns are covered. If a required row is forbidden or
+// shares a column with an earlier required row there is no solution. Undo
+// runs in exactly the reverse order.
+
+bool DLX2::Assume(const Soln&require, const Soln&forbid, vector<Node2*>&O, vector<Node2*>&removed)
+{
+	for (const auto&r : require) { if (r >= n.first.size()) { throw(runtime_error("required row out of range")); } }
+	for (const auto&r : forbid) { if (r >= n.first.size()) { throw(runtime_error("forbidden row out of range")); } }
+
+	vector<bool>out(n.first.size(), false); // forbidden rows
+	for (const auto&f : forbid)
+	{
+		if (out[f]) { continue; } // removing twice would break the links
+		out[f] = true;
+		Node2*const r(&n.v[n.first[f]]);
+		RemoveRow(r);
+		removed.emplace_back(r);
+	}
+
+	vector<bool>in(n.first.size(), false); // required rows
+	vector<bool>covered(n.vh.size(), false);
+	for (const auto&q : require)
+	{
+		if (in[q]) { continue; } // already chosen
+		in[q] = true;
+		Node2*const r(&n.v[n.first[q]]);
+		if (out[q]) { return false; } // required and forbidden
+		Node2*j(r);
+		do { // all the nodes in row, including r
+			if (covered[j->C - n.vh.data()]) { return false; } // conflicts with earlier required row
+			j = j->R;
+		} while (j != r);
+		do {
+			covered[j->C - n.vh.data()] = true;
+			j = j->R;
+		} while (j != r);
+		O.emplace_back(r);
+		ChooseRow(r);
+	}
+	return true;
+}
+
+void DLX2::Unassume(vector<Node2*>&O, vector<Node2*>&removed)
+{
+	for (; !O.empty(); O.pop_back()) { UnchooseRow(O.back()); } // required rows, reverse order
+	for (; !removed.empty(); removed.pop_back()) { RestoreRow(removed.back()); } // forbidden rows, reverse order
+}
+
+bool DLX2::Pruned(HeadNode2*const hh)
+{
+	open.clear();
+	for (HeadNode2*c = static_cast<HeadNode2*>(hh->R); c != hh; c = static_cast<HeadNode2*>(c->R)) { open.emplace_back(c->N); }
+	return prune(open);
+}
+
+// true if the bitmask endgame takes over the subtree: few primary columns
+// left, and the open columns and the rows still in play fit, see Endgame.h
+bool DLX2::StartEndgame(HeadNode2*const hh)
+{
+	unsigned int cols(0);
+	size_t nodes(0);
+	for (Node2*c = hh->R; c != hh && cols <= endgame; c = c->R)
+	{
+		++cols;
+		nodes += static_cast<HeadNode2*>(c)->S;
+	}
+	if (cols > endgame || nodes > widest * Endgame::ROWS) { return false; } // too many columns, or surely too many rows
+	eg.Clear(n.vh.size(), n.v.size());
+	Endgame::Mask need(0);
+	for (Node2*c = hh->R; c != hh; c = c->R) { eg.Map(static_cast<HeadNode2*>(c) - n.vh.data(), need); } // primary columns get bits in list order
+	for (Node2*c = hh->R; c != hh; c = c->R)
+	{
+		for (Node2*i = c->D; i != c; i = i->D)
+		{
+			if (eg.Marked(i - n.v.data())) { continue; } // added from another column
+			Endgame::Mask m(0);
+			Node2*j(i);
+			do {
+				if (!eg.Map(j->C - n.vh.data(), m)) { return false; } // too many secondary columns, maybe further down
+				eg.Mark(j - n.v.data());
+				j = j->R;
+			} while (j != i);
+			if (!eg.Add(m, i - n.v.data())) { return false; }
+		}
+	}
+	eg.Start(need, cur.bulk, stop);
+	return true;
+}
+
+// Propagation
+// -----------
+// After each choice the problem is reduced without creating branch points: a
+// column with a single row left forces that row, a column with no rows left
+// fails the branch wherever it is in the list. Propagate::Rows also removes
+// rows that would leave some other primary column without rows. Every step
+// goes on the trail; Search takes a level's steps back when the level ends.
+
+bool DLX2::Propagated(HeadNode2*const hh, vector<Node2*>&O)
+{
+	for (bool again(true); again;)
+	{
+		for (HeadNode2*c = static_cast<HeadNode2*>(hh->R); c != hh;)
+		{
+			if (!c->S) { return false; } // dead column
+			if (1 == c->S) // forced row
+			{
+				Node2*const r(c->D);
+				O.emplace_back(r);
+				ChooseRow(r);
+				trail.push_back({ r, true });
+				c = static_cast<HeadNode2*>(hh->R); // list changed, rescan
+				continue;
+			}
+			c = static_cast<HeadNode2*>(c->R);
+		}
+		again = Propagate::Rows == propagate && PruneRows(hh);
+	}
+	return true;
+}
+
+bool DLX2::PruneRows(HeadNode2*const hh)
+{
+	if (look.seen.empty()) // first use
+	{
+		look.mine.resize(n.vh.size());
+		look.counted.resize(n.vh.size());
+		look.count.resize(n.vh.size());
+		look.hit.resize(n.first.size());
+		look.seen.resize(n.first.size());
+	}
+	++look.pass;
+	bool pruned(false);
+	for (HeadNode2*c = static_cast<HeadNode2*>(hh->R); c != hh; c = static_cast<HeadNode2*>(c->R))
+	{
+		for (Node2*i = c->D; i != c; i = i->D) // a removed node keeps its links, so iteration goes on
+		{
+			const unsigned int row(n.Row(i));
+			if (look.pass == look.seen[row]) { continue; } // tested from another column
+			look.seen[row] = look.pass;
+			if (Hopeless(i))
+			{
+				RemoveRow(i);
+				trail.push_back({ i, false });
+				pruned = true;
+			}
+		}
+	}
+	return pruned;
+}
+
+// true if taking the row would leave a primary column with no rows
+bool DLX2::Hopeless(Node2*const r)
+{
+	const auto eval(++look.eval);
+	Node2*j(r);
+	do {
+		look.mine[j->C - n.vh.data()] = eval;
+		j = j->R;
+	} while (j != r);
+	do {
+		for (Node2*k = j->D; k != j; k = k->D) // other rows in the column, each leaves with the tested row
+		{
+			if (k == j->C) { continue; } // head node
+			const unsigned int row(n.Row(k));
+			if (eval == look.hit[row]) { continue; } // already met in another column
+			look.hit[row] = eval;
+			for (Node2*m = k->R; m != k; m = m->R)
+			{
+				const HeadNode2*const y(m->C);
+				const size_t iy(y - n.vh.data());
+				if (eval == look.mine[iy]) { continue; } // covered by the tested row
+				if (eval != look.counted[iy]) { look.counted[iy] = eval; look.count[iy] = y->S; }
+				if (!--look.count[iy] && y->N < int(n.pc)) { return true; }
+			}
+		}
+		j = j->R;
+	} while (j != r);
+	return false;
+}
+
+void DLX2::Unpropagate(const size_t mark, vector<Node2*>&O)
+{
+	for (; trail.size() > mark; trail.pop_back())
+	{
+		if (trail.back().forced)
+		{
+			UnchooseRow(trail.back().r);
+			O.pop_back();
+		}
+		else { RestoreRow(trail.back().r); }
+	}
+}
+
+// Row order
+// ---------
+// Before a column is covered its rows are relinked in the order they are to
+// be tried, by rank, ties in input order. The previous order is saved and
+// relinked after Uncover, so Cover and Uncover see the same order and rows
+// hidden by earlier levels find their neighbours again. Column c itself does
+// not change while it is covered. Rank for Order::Eliminate: the sizes of
+// the row's other columns added up, rows that leave more choices first. For
+// Order::Learned: the subtrees below the row that ended without a solution
+// so far, then as Eliminate; at the start of a search that is Eliminate.
+
+void DLX2::Reorder(HeadNode2*const c)
+{
+	ranked.clear();
+	for(Node2*i=c->D;i!=c;i=i->D)
+	{
+		cur.saved.emplace_back(i);
+		unsigned long long eliminate(0);
+		for(Node2*j=i->R;j!=i;j=j->R){eliminate+=j->C->S-1;}
+		const unsigned long long learned(Order::Learned==order?dead[n.Row(i)]:0);
+		ranked.push_back({learned<<32|min(eliminate,0xffffffffull),i});
+	}
+	stable_sort(ranked.begin(),ranked.end(),[](const Ranked&a,const Ranked&b){return a.key<b.key;});
+	Node2*p(c);
+	for(const auto&x:ranked){p->D=x.r;x.r->U=p;p=x.r;}
+	p->D=c;c->U=p;
+}
+
+void DLX2::Restore(HeadNode2*const c)
+{
+	const auto first(cur.saved.end()-c->S); // this column's rows are the innermost saved
+	Node2*p(c);
+	for(auto i(first);i!=cur.saved.end();++i){p->D=*i;(*i)->U=p;p=*i;}
+	p->D=c;c->U=p;
+	cur.saved.erase(first,cur.saved.end());
+}
+
+// Row operations
+// --------------
+
+void DLX2::ChooseRow(Node2*const r) // as Search takes a row: its column, then the other nodes left to right
+{
+	Node2*j(r);
+	do {
+		Cover(j->C);
+		j = j->R;
+	} while (j != r);
+}
 
-	if(!n.Comp(x)){throw(runtime_error("node structure integrity failure"));}
-	cout<<"Node2 structure integrity verified.\n";
+void DLX2::UnchooseRow(Node2*const r)
+{
+	Node2*j(r);
+	do {
+		j = j->L;
+		Uncover(j->C);
+	} while (j != r);
+}
+
+void DLX2::RemoveRow(Node2*const r) // take a row out of its columns without covering them
+{
+	Node2*j(r);
+	do {
+		j->D->U = j->U;
+		j->U->D = j->D;
+		--(j->C->S);
+		j = j->R;
+	} while (j != r);
+}
+
+void DLX2::RestoreRow(Node2*const r)
+{
+	Node2*j(r);
+	do {
+		j = j->L;
+		++(j->C->S);
+		j->D->U = j;
+		j->U->D = j;
+	} while (j != r);
+}
+
+DLX2::Range DLX2::Solutions(const Soln&require,const Soln&forbid)
+{
+	Begin(require,forbid);
+	return Range(this);
+}
+
+void DLX2::Begin(const Soln&require,const Soln&forbid)
+{
+	if(Cursor::At::Idle!=cur.at){throw(runtime_error("search already in progress"));}
+	if(cur.rStack.size()!=n.v.size()){cur.rStack.resize(n.v.size());} // fixed preallocated buffer, space overkill using count of all nodes
+	if(Propagate::Off!=propagate&&cur.mark.size()!=n.v.size()+1){cur.mark.resize(n.v.size()+1);}
+	cur.irStack=0;
+	cur.quit=false;
+	cur.bulk=false;
+	cur.fetch=false;
+	cur.depth=0;
+	cur.leaf=1;
+	cur.saved.clear();
+	cur.stops=0;
+	if(Order::Learned==order)
+	{
+		dead.assign(n.first.size(),0);
+		if(cur.before.size()!=n.v.size()){cur.before.resize(n.v.size());}
+	}
+	cur.at=Assume(require,forbid,cur.O,cur.removed)?Cursor::At::Start:Cursor::At::Done;
+}
+
+void DLX2::BeginSteps(const Soln&require,const Soln&forbid,const bool bulk,const size_t depth,const bool fetch)
+{
+	Begin(require,forbid);
+	cur.bulk=bulk;
+	cur.depth=depth;
+	cur.fetch=fetch;
+}
+
+DLX2::Stop DLX2::Step()
+{
+	if(!Resume())
+	{
+		Finish();
+		return Stop::Done;
+	}
+	switch(cur.at)
+	{
+	case Cursor::At::Prefix: return Stop::Prefix;
+	case Cursor::At::Fetch: return Stop::Fetch;
+	default: return Stop::Soln;
+	}
+}
+
+void DLX2::Finish() // unwind a search left early, take back assumptions
+{
+	if(Cursor::At::Start==cur.at){cur.at=Cursor::At::Done;} // never started
+	cur.quit=true;
+	while(Resume()){}
+	Unassume(cur.O,cur.removed);
+	cur.at=Cursor::At::Idle;
 }
 
 // optimization:	remove recursion from search
 // result:			no improvement
 // conclusion:		in below case, compiler does at least as good a job as I can do by hand
+// The explicit stack makes the search resumable: it suspends at a solution by
+// saving its stack depth and returning, and resumes at the pop label.
 
-void DLX2::Search(HeadNode2* const hh,vector<Node2*>&Soln)
+bool DLX2::Resume()
 {
+	HeadNode2*const hh(&n.vh[0]);
 	// because of goto recursion replacement, it is necessary to have a dummy value which is never used
 	HeadNode2*c = hh;
+	Node2*r = nullptr; // declared before the labels so goto does not cross its initialization
+
+	vector<Node2*>&rStack(cur.rStack);
+	vector<Node2*>::size_type irStack(cur.irStack);
+	vector<Node2*>&Soln(cur.O);
 
-	vector<Node2*>rStack(n.v.size(),nullptr); // fixed preallocated buffer, space overkill using count of all nodes
-	vector<Node2*>::size_type irStack(0); // index of unused position (i.e. rStack.end() )
+	if(Cursor::At::Done==cur.at){return false;}
+	if(Cursor::At::Soln==cur.at){goto pop;} // continue after the solution returned last time
+	if(Cursor::At::Endgame==cur.at){goto endgame;} // continue the endgame of this level
+	if(Cursor::At::Prefix==cur.at){goto pop;} // the subtree below is searched elsewhere
+	if(Cursor::At::Fetch==cur.at){r=cur.row;c=r->C;goto fetch;}
 
 recurse:
+	if(Propagate::Off!=propagate)
+	{
+		cur.mark[irStack]=trail.size();
+		if(!Propagated(hh,Soln)){goto pop;} // a column lost all its rows
+	}
 
 	if(hh==hh->R) // no head nodes
 	{
-		Notify(Event::Soln);
-		if(show){ShowSolution(Soln);}
-		goto pop; // was: return;
+		cur.leaf=1;
+		++cur.stops;
+		cur.irStack=irStack;
+		cur.at=Cursor::At::Soln;
+		return true; // was: report solution, return
+	}
+	if(prune&&Pruned(hh)){goto pop;}
+	if(cur.depth&&cur.depth==irStack) // deep enough, the caller searches below this partial solution
+	{
+		++cur.stops;
+		cur.irStack=irStack;
+		cur.at=Cursor::At::Prefix;
+		return true;
+	}
+	if(cur.bulk&&hh->R->R==hh) // counting, one primary column left: each of its rows completes a solution
+	{
+		cur.leaf=static_cast<HeadNode2*>(hh->R)->S;
+		if(!cur.leaf){goto pop;}
+		++cur.stops;
+		cur.irStack=irStack;
+		cur.at=Cursor::At::Soln;
+		return true;
 	}
 
 	c=ChooseColumn(hh);
@@ -129,9 +525,42 @@ recurse:
 		goto pop; // was: return;
 	}
 	
+	if(endgame&&StartEndgame(hh)) // the bitmask endgame finishes this level's subtree
+	{
+	endgame:
+		Soln.resize(Soln.size()-eg.Picks().size()); // rows of the endgame's last solution
+		if(!cur.quit&&eg.Next())
+		{
+			for(const auto&i:eg.Picks()){Soln.emplace_back(&n.v[i]);}
+			cur.leaf=eg.Leaf();
+			++cur.stops;
+			cur.irStack=irStack;
+			cur.at=Cursor::At::Endgame;
+			return true;
+		}
+		goto pop;
+	}
+
+	if(Order::Input!=order){Reorder(c);}
 	Cover(c);
-	for(Node2*r=c->D;r!=c;r=r->D) // all the rows in column c
+	for(r=c->D;r!=c;r=r->D) // all the rows in column c
 	{
+		if(cur.fetch) // let other searches run while the row's columns load, see Step
+		{
+			cur.chain.clear();
+			for(Node2*j=r->R;j!=r;j=j->R) // Cover starts there, the row itself was just visited by Cover(c)
+			{
+				Prefetch(j->C->D);
+				cur.chain.push_back(j->C);
+			}
+			cur.row=r;
+			cur.irStack=irStack;
+			cur.at=Cursor::At::Fetch;
+			return true;
+		fetch:
+			if(cur.quit||Stopped()){break;}
+			if(FetchDown()){return true;}
+		}
 		Soln.emplace_back(r); // implements: set Soln sub k ← r;
 		for(Node2*j=r->R;j!=r;j=j->R) // all the nodes in row
 		{
@@ -139,23 +568,54 @@ recurse:
 		}        
 
 		// replace recursion: Search(hh,k+1,Soln);
+		if(Order::Learned==order){cur.before[irStack]=cur.stops;}
 		rStack[irStack++] = r;
 		goto recurse;
 	pop:
-		if (!irStack) { return; } // stack is fully unwound
+		if(Propagate::Off!=propagate){Unpropagate(cur.mark[irStack],Soln);} // level ends, take back its propagation
+		if (!irStack) // stack is fully unwound
+		{
+			cur.irStack=0;
+			cur.at=Cursor::At::Done;
+			return false;
+		}
 		r = rStack[--irStack];
 		c = r->C;
+		if(Order::Learned==order&&cur.stops==cur.before[irStack]){++dead[n.Row(r)];} // nothing found below r
 
 		Soln.pop_back();
 		for(Node2*j=r->L;j!=r;j=j->L) // all the nodes in row
 		{
 			Uncover(j->C);
 		}        
+		if(cur.quit||Stopped()){break;}
 	}
 	Uncover(c);
+	if(Order::Input!=order){Restore(c);}
 	goto pop; // was: default return
 }
 
+// One node further down each other column of the row at a Fetch stop, that
+// node arrived during the other searches' turns: prefetch the nodes above
+// and below the rest of its row, which Cover relinks, and the next node
+// down. False once every column is walked.
+bool DLX2::FetchDown()
+{
+	bool more(false);
+	auto p(cur.chain.begin());
+	for(Node2*j=cur.row->R;j!=cur.row;j=j->R,++p)
+	{
+		if(!*p){continue;}
+		Node2*const i((*p)->D);
+		if(i==j->C){*p=nullptr;continue;} // back at the head
+		for(Node2*k=i->R;k!=i;k=k->R){Prefetch(k->U);Prefetch(k->D);}
+		Prefetch(i->D);
+		*p=i;
+		more=true;
+	}
+	return more;
+}
+
 void DLX2::Cover(HeadNode2*const c)
 {
 	// remove self from head node list
@@ -212,19 +672,12 @@ HeadNode2*DLX2::ChooseColumn(HeadNode2*const hh)const // least covered column
 
 void DLX2::ShowSolution(const std::vector<Node2*>&O)const
 {
-	cout << "[\n";
-
+	Soln soln;
 	for (const auto& r : O)
 	{
-		cout << r->C->N << " ";
-		for (Node2*j = r->R; j != r; j = j->R) // all the nodes in row
-		{
-			cout << j->C->N << " ";
-		}
-		cout << "\n";
+		soln.emplace_back(n.Row(r));
 	}
-
-	cout << "]\n";
+	show(soln);
 }
 
 // consider:
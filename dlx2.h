@@ -1,8 +1,11 @@
 // dlx2 solver interface
 // Bill Ola Rasmussen
+#pragma once
+
 #include "Solver.h"
+#include "ProblemMatrix.h"
+#include "Endgame.h"
 #include <vector>
-#include <memory>
 
 class HeadNode2;
 class Node2 {
@@ -10,14 +13,9 @@ public:
 	Node2*L,*R,*U,*D; // left, right, up, down
 	HeadNode2*C; // head
 	Node2():L(this),R(this),U(this),D(this),C(nullptr){}
-	virtual ~Node2(){}
 	Node2*LinkL(Node2*p);
 	// node integrity test support
-	virtual std::unique_ptr<Node2>Clone()const{return std::unique_ptr<Node2>(new Node2(*this));}
-	virtual bool Same(const Node2*const n)const
-	{
-		return L==n->L&&R==n->R&&U==n->U&&D==n->D&&C==n->C;
-	}
+	bool operator==(const Node2&n)const{return L==n.L&&R==n.R&&U==n.U&&D==n.D&&C==n.C;}
 };
 
 class HeadNode2 : public Node2 {
@@ -27,43 +25,142 @@ public:
 	HeadNode2():Node2(),S(0){}
 	Node2*LinkU(Node2*p);
 	// node integrity test support
-	std::unique_ptr<Node2>Clone()const override{return std::unique_ptr<HeadNode2>(new HeadNode2(*this));}
-	bool Same(const Node2*const n)const override// must have same signature, so casting later on...
-	{
-		const auto h(dynamic_cast<const HeadNode2*const>(n));
-		return h&&Node2::Same(n)&&S==h->S&&N==h->N;
-	}
+	bool operator==(const HeadNode2&h)const{return Node2::operator==(h)&&S==h.S&&N==h.N;}
 };
 
-// The implementation of the algorithm uses raw pointers. Node2 lifetime
-// is managed by unique_ptr vector.
+// The implementation of the algorithm uses raw pointers. Node2 is a plain
+// struct, all nodes live in one contiguous arena in row-major order, sized
+// from the problem matrix up front.
 
 struct RaiiNodes2 {
-	std::vector<std::unique_ptr<Node2>>v;
 	std::vector<HeadNode2>vh; // contiguous vector of all head nodes, no heap allocation
-	void V(Node2*p) { v.emplace_back(std::unique_ptr<Node2>(p)); }
+	std::vector<Node2>v; // contiguous vector of all other nodes, the nodes of a tile are adjacent
+	std::vector<std::size_t>first; // index into v of the first node of each row
+	unsigned int pc; // primary constraint count, head names 0 to pc-1
+	explicit RaiiNodes2(const ProblemMatrix&pm);
 	HeadNode2*GetHead(int col); // col is -1 for header head, aka. hh
+	unsigned int Row(const Node2*p)const; // input row number of a node
 	// node integrity test support
-	std::vector<std::unique_ptr<Node2>> Snap()const;
-	bool Comp(std::vector<std::unique_ptr<Node2>>&x)const;
+	struct Snapshot{std::vector<HeadNode2>vh;std::vector<Node2>v;};
+	Snapshot Snap()const{return Snapshot{vh,v};}
+	bool Comp(const Snapshot&x)const{return x.vh==vh&&x.v==v;}
+	unsigned long long Sum()const; // checksum of all link fields
 };
 
 class DLX2:public Solver{
 	RaiiNodes2 n; // allocation bucket
-	Node2*rowStart; // used for inserting rows and columns when reading 
 	std::function<void(Event)>Notify;
-	bool show;
-	void Search(HeadNode2*const hh,std::vector<Node2*>&O);
+	Show show;
+	struct Cursor{ // resumable search state, see Resume
+		std::vector<Node2*>rStack; // row chosen at each level
+		std::vector<std::size_t>mark; // trail size at each level, before propagation
+		std::vector<Node2*>O; // required rows, then rows chosen by search
+		std::vector<Node2*>removed; // forbidden rows
+		std::vector<Node2*>::size_type irStack=0; // index of unused position (i.e. rStack.end() )
+		enum class At:char{Idle,Start,Soln,Endgame,Prefix,Fetch,Done}at=At::Idle; // Endgame: stopped at a solution of the endgame, others see Step
+		bool quit=false; // unwind without searching further
+		bool fetch=false; // stop before taking each row, see Step
+		std::vector<Node2*>::size_type depth=0; // stop at partial solutions of this many chosen rows, 0 never
+		Node2*row=nullptr; // row about to be taken at a Fetch stop
+		std::vector<Node2*>chain; // Fetch: node reached down each other column of row, nullptr once at its end
+		bool bulk=false; // counting: stop one level early, see leaf
+		Count leaf=1; // solutions at the last stop: 1, or more when bulk
+		std::vector<Node2*>saved; // rows of each reordered column in their order before, innermost last, see Reorder
+		Count stops=0; // solution stops so far, Order::Learned
+		std::vector<Count>before; // stops when the row at each level was taken, Order::Learned
+	}cur;
+	void Begin(const Soln&require,const Soln&forbid);
+	bool Resume(); // continue search to the next solution, false when done
+	void Finish();
 	void ShowSolution(const std::vector<Node2*>&O)const;
 	HeadNode2*ChooseColumn(HeadNode2*const hh)const;
 	void Cover(HeadNode2*const c);
 	void Uncover(HeadNode2*const c);
+	bool FetchDown();
+	bool Assume(const Soln&require,const Soln&forbid,std::vector<Node2*>&O,std::vector<Node2*>&removed);
+	void Unassume(std::vector<Node2*>&O,std::vector<Node2*>&removed);
+	struct Step{Node2*r;bool forced;}; // propagation trail: node of a forced row taken, or pruned row
+	std::vector<Step>trail;
+	struct Lookahead{ // Propagate::Rows scratch, stamped so nothing is cleared between uses
+		std::vector<unsigned long long>mine,counted,hit,seen; // stamps: column in tested row, count valid, row met, row tested this pass
+		std::vector<int>count; // column sizes left if the tested row were taken
+		unsigned long long eval=0,pass=0;
+	}look;
+	std::vector<unsigned int>open; // primary columns passed to prune
+	bool Pruned(HeadNode2*const hh);
+	Endgame eg;
+	std::size_t widest; // most primary columns in a row, bounds the residual row count from below
+	bool StartEndgame(HeadNode2*const hh);
+	bool Propagated(HeadNode2*const hh,std::vector<Node2*>&O);
+	bool PruneRows(HeadNode2*const hh);
+	bool Hopeless(Node2*const r);
+	void Unpropagate(const std::size_t mark,std::vector<Node2*>&O);
+	struct Ranked{unsigned long long key;Node2*r;};
+	std::vector<Ranked>ranked; // Reorder scratch
+	std::vector<unsigned int>dead; // Order::Learned: subtrees without a solution below each input row, this search
+	void Reorder(HeadNode2*const c);
+	void Restore(HeadNode2*const c);
+	void ChooseRow(Node2*const r);
+	void UnchooseRow(Node2*const r);
+	void RemoveRow(Node2*const r);
+	void RestoreRow(Node2*const r);
 public:
-	DLX2(){} // should not need to define this?
-	void Init(const unsigned int pc, const unsigned int sc) override;
-	void Row(const unsigned int col) override;
-	void Col(const unsigned int col) override;
-	void Solve(const bool showSoln, std::function<void(Event)>CallBack) override;
+	// Pull based search:
+	//	for(auto&soln:dlx2.Solutions()){...}
+	// The search suspends at each solution and resumes where it left off when
+	// the loop advances. Leaving the loop early unwinds the search and restores
+	// the structure. One search at a time per solver.
+	class SolnView{ // current solution, valid until the search resumes
+		const RaiiNodes2*n;
+		const std::vector<Node2*>*O;
+	public:
+		SolnView(const RaiiNodes2*nodes,const std::vector<Node2*>*rows):n(nodes),O(rows){}
+		std::size_t size()const{return O->size();}
+		unsigned int operator[](const std::size_t i)const{return n->Row((*O)[i]);} // input row number
+		const std::vector<Node2*>&Nodes()const{return *O;} // the search row stack itself, no copy
+		operator Soln()const{Soln s;for(const auto&r:*O){s.emplace_back(n->Row(r));}return s;}
+	};
+	class Range{
+		DLX2*s;
+	public:
+		class iterator{
+			DLX2*s; // nullptr at end
+			SolnView view;
+		public:
+			explicit iterator(DLX2*p):s(p),view(p?&p->n:nullptr,p?&p->cur.O:nullptr){}
+			const SolnView&operator*()const{return view;}
+			iterator&operator++(){if(!s->Resume()){s=nullptr;}return *this;}
+			bool operator!=(const iterator&i)const{return s!=i.s;}
+			bool operator==(const iterator&i)const{return s==i.s;}
+		};
+		explicit Range(DLX2*p):s(p){}
+		Range(Range&&x):s(x.s){x.s=nullptr;}
+		Range(const Range&)=delete;
+		Range&operator=(const Range&)=delete;
+		~Range(){if(s){s->Finish();}}
+		iterator begin(){return iterator(s&&s->Resume()?s:nullptr);} // runs to the first solution, call once
+		iterator end(){return iterator(nullptr);}
+	};
+	Range Solutions(const Soln&require=Soln(),const Soln&forbid=Soln());
+	// Stepwise search, for several searches taking turns on one thread, see
+	// ilx.h. Step returns at each solution, Leaf of them when bulk, and:
+	//	Fetch	before taking a row, once for each node down its longest
+	//			other column: the first stop prefetches the first node of
+	//			each column, where Cover starts, each later one goes one node
+	//			further down each column and prefetches the next node and
+	//			the neighbours Cover relinks, so the loads of the dependent
+	//			chain run while the other searches take their turns
+	//	Prefix	with depth set, at each partial solution of depth chosen rows,
+	//			Current holds it, the search does not go below it
+	//	Done	the search is over and the structure restored
+	enum class Stop:char{Fetch,Soln,Prefix,Done};
+	void BeginSteps(const Soln&require,const Soln&forbid,const bool bulk,const std::size_t depth,const bool fetch);
+	Stop Step();
+	Count Leaf()const{return cur.leaf;}
+	SolnView Current()const{return SolnView(&n,&cur.O);}
+	explicit DLX2(const ProblemMatrix&pm):n(pm),widest(pm.PrimaryWidth()){}
+	void Solve(Show ShowSoln, std::function<void(Event)>CallBack) override;
+	void SolveAssuming(const Soln&require, const Soln&forbid, Show ShowSoln, std::function<void(Event)>CallBack) override;
 	DLX2&operator=(const DLX2&)=delete; // no assignment
 	DLX2(const DLX2&)=delete; // no copy constructor
 };
@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+# Solve exact cover problems in process with libexactcover.so
+# Bill Ola Rasmussen
+# version 1.0
+
+# ctypes bindings for the C interface in ExactCover.h, build the library
+# with make. Rows are passed as buffers of 32 bit integers, such as
+# array.array('i') or numpy int32 arrays, which the library reads in place:
+# no text, no conversion. The generators build such buffers, see rowArrays
+# in CreateQueensData.py and CreateYpentominoData.py.
+# Settings are those of ExactCover.h. Example:
+#   exactcover.py queens 12 -solver=dix
+#   exactcover.py pentomino 10 14 -limit=3 -keep=1
+
+import ctypes
+import os
+import sys
+import time
+
+SOLUTION=ctypes.CFUNCTYPE(ctypes.c_int,ctypes.c_void_p,ctypes.POINTER(ctypes.c_int32),ctypes.c_size_t)
+
+_lib=None
+
+def load(path=None):
+    'the library, by default libexactcover.so next to this file'
+    global _lib
+    if path is None and _lib is not None:
+        return _lib
+    lib=ctypes.CDLL(path or os.path.join(os.path.dirname(os.path.abspath(__file__)),'libexactcover.so'))
+    p,i32,i32p,size=ctypes.c_void_p,ctypes.c_int32,ctypes.POINTER(ctypes.c_int32),ctypes.c_size_t
+    for name,res,args in (('ec_create',p,[i32,i32]),
+                          ('ec_destroy',None,[p]),
+                          ('ec_error',ctypes.c_char_p,[p]),
+                          ('ec_add_rows',ctypes.c_int,[p,i32p,size,i32p,size]),
+                          ('ec_add_rows_fixed',ctypes.c_int,[p,i32p,size,size]),
+                          ('ec_rows',size,[p]),
+                          ('ec_set',ctypes.c_int,[p,ctypes.c_char_p,ctypes.c_char_p]),
+                          ('ec_solve',ctypes.c_int,[p,SOLUTION,p]),
+                          ('ec_found',ctypes.c_uint64,[p]),
+                          ('ec_found_text',ctypes.c_char_p,[p]),
+                          ('ec_status',ctypes.c_char_p,[p]),
+                          ('ec_solutions',size,[p]),
+                          ('ec_solution',i32p,[p,size,ctypes.POINTER(size)])):
+        f=getattr(lib,name)
+        f.restype,f.argtypes=res,args
+    if path is None:
+        _lib=lib
+    return lib
+
+def int32s(buf):
+    'ctypes array over a contiguous buffer of 32 bit integers, no copy unless the buffer is read only'
+    m=memoryview(buf)
+    if m.itemsize!=4 or m.format[-1] not in 'il':
+        raise TypeError('rows must be 32 bit integers, e.g. array.array("i") or numpy int32, not '+m.format)
+    if not m.c_contiguous:
+        raise ValueError('rows must be a contiguous buffer')
+    n=m.nbytes//4
+    if m.readonly:
+        return (ctypes.c_int32*n).from_buffer_copy(m)
+    return (ctypes.c_int32*n).from_buffer(m.cast('B'))
+
+class Problem:
+    'exact cover problem held by the library: add rows, then solve'
+    def __init__(self,primary,secondary=0,lib=None):
+        self.lib=lib or load()
+        self.p=self.lib.ec_create(primary,secondary)
+        if not self.p:
+            raise ValueError('bad constraint counts')
+    def close(self):
+        if self.p:
+            self.lib.ec_destroy(self.p)
+            self.p=None
+    def __del__(self):
+        self.close()
+    def __enter__(self):
+        return self
+    def __exit__(self,*exc):
+        self.close()
+    def _check(self,result):
+        if result:
+            raise RuntimeError(self.lib.ec_error(self.p).decode())
+    def addRows(self,cols,lengths=None,width=None):
+        '''rows back to back in cols: of lengths[i] columns each, or all of
+        width columns, which a 2 dimensional buffer gives by its shape; a
+        bad row fails the call and adds no rows
+        >>> import array
+        >>> with Problem(2) as p:
+        ...     p.addRows(array.array('i',[0,0]),width=2)
+        Traceback (most recent call last):
+        RuntimeError: column repeated in row 0
+        >>> with Problem(2) as p:
+        ...     p.addRows(array.array('i',[0,1,1,1]),lengths=array.array('i',[2,2]))
+        Traceback (most recent call last):
+        RuntimeError: column repeated in row 1
+        >>> with Problem(2) as p:
+        ...     try:
+        ...         p.addRows(array.array('i',[0,1,1,1]),width=2)
+        ...     except RuntimeError:
+        ...         pass
+        ...     p.addRows(array.array('i',[0,1]),width=2)
+        ...     p.rows(),p.solve()
+        (1, 1)
+        '''
+        c=int32s(cols)
+        if lengths is not None:
+            n=int32s(lengths)
+            self._check(self.lib.ec_add_rows(self.p,c,len(c),n,len(n)))
+            return
+        if width is None:
+            shape=memoryview(cols).shape
+            if len(shape)!=2:
+                raise ValueError('rows need lengths or a width')
+            width=shape[1]
+        if not width or len(c)%width:
+            raise ValueError('column count not a multiple of the width')
+        self._check(self.lib.ec_add_rows_fixed(self.p,c,width,len(c)//width))
+    def rows(self):
+        return self.lib.ec_rows(self.p)
+    def set(self,**settings):
+        for k,v in settings.items():
+            self._check(self.lib.ec_set(self.p,k.encode(),str(v).encode()))
+    def solve(self,callback=None,**settings):
+        '''solution count; callback gets the row numbers of each solution, a
+        true result ends the search; settings are applied first'''
+        self.set(**settings)
+        fn=SOLUTION(lambda user,rows,n:bool(callback(rows[:n]))) if callback else SOLUTION()
+        self._check(self.lib.ec_solve(self.p,fn,None))
+        return int(self.lib.ec_found_text(self.p))
+    def status(self):
+        'how the last solve ended: complete, limit, timeout or stopped'
+        return self.lib.ec_status(self.p).decode()
+    def solutions(self):
+        'row numbers of each solution kept by the last solve'
+        n=ctypes.c_size_t()
+        for i in range(self.lib.ec_solutions(self.p)):
+            rows=self.lib.ec_solution(self.p,i,ctypes.byref(n))
+            yield rows[:n.value]
+
+def problem(args):
+    'problem built by a generator from command line arguments'
+    if args[0]=='queens' and len(args)==2:
+        import CreateQueensData
+        (pc,sc),cols,lengths=CreateQueensData.rowArrays(int(args[1]))
+        p=Problem(pc,sc)
+        p.addRows(cols,lengths=lengths)
+        return p
+    if args[0]=='pentomino' and len(args)==3:
+        import CreateYpentominoData
+        (pc,sc),cols=CreateYpentominoData.rowArrays(int(args[1]),int(args[2]))
+        p=Problem(pc,sc)
+        p.addRows(cols,width=5)
+        return p
+    raise ValueError('unknown problem: '+' '.join(args))
+
+if __name__ == "__main__":
+    args=[a for a in sys.argv[1:] if not a.startswith('-')]
+    settings=dict(a[1:].split('=',1) for a in sys.argv[1:] if a.startswith('-'))
+    if not args:
+        print('usage: '+sys.argv[0]+' queens N | pentomino W H [-name=value ...], settings in ExactCover.h')
+        print('running unit tests...')
+        import doctest
+        doctest.testmod()
+        print('done.')
+        sys.exit(1)
+    settings.setdefault('keep','0')
+    begin=time.perf_counter()
+    with problem(args) as p:
+        built=time.perf_counter()
+        count=p.solve(**settings)
+        end=time.perf_counter()
+        for s in p.solutions():
+            print(' '.join(map(str,s)))
+        print(p.rows(),'rows generated in %.3f seconds'%(built-begin))
+        print(count,'solution(s) found,',p.status()+', solve time: %.3f seconds'%(end-built))
@@ -0,0 +1,86 @@
+// interleaved dlx2 solver: several subtree searches take turns on one thread to overlap their cache misses
+// Bill Ola Rasmussen
+
+#include "ilx.h"
+#include <stdexcept>
+#include <iostream>
+using namespace std;
+
+ILX::ILX(const ProblemMatrix& pm, const unsigned int lanes)
+{
+	if (!lanes) { throw(runtime_error("interleaved search needs at least one lane")); }
+	for (unsigned int k(0); k < lanes; ++k) { _lane.emplace_back(new DLX2(pm)); }
+}
+
+void ILX::Settings(DLX2& d) const
+{
+	d.propagate = propagate;
+	d.order = order;
+	d.prune = prune; // a copy each, pruners keep scratch state
+	d.endgame = endgame;
+	d.stop = stop;
+	d.out = out;
+}
+
+void ILX::Solve(Show ShowSoln, std::function<void(Event)>CallBack)
+{
+	SolveAssuming(Soln(), Soln(), ShowSoln, CallBack);
+}
+
+void ILX::SolveAssuming(const Soln& require, const Soln& forbid, Show ShowSoln, std::function<void(Event)>CallBack)
+{
+	if (Check::Off != check) { throw(runtime_error("ilx does not check its structures, use dlx2")); }
+	*out << "ILX::Solve with " << _lane.size() << " interleaved dlx2 lanes\n";
+	for (auto& d : _lane) { Settings(*d); }
+	const bool bulk(!ShowSoln);
+	found = 0;
+	CallBack(Event::Begin);
+
+	// cut the tree at the shallowest depth giving each lane several subtrees,
+	// solutions above the cut are found on the way
+	struct Shallow { Soln rows; Count leaf; };
+	vector<Shallow> shallow;
+	vector<Soln> task; // partial solutions at the cut, required rows first
+	const size_t want(8 * _lane.size());
+	DLX2& first(*_lane[0]);
+	for (size_t depth(1); ; ++depth) {
+		shallow.clear();
+		task.clear();
+		first.BeginSteps(require, forbid, bulk, depth, false);
+		for (DLX2::Stop s; DLX2::Stop::Done != (s = first.Step());) {
+			if (DLX2::Stop::Prefix == s) { task.emplace_back(first.Current()); }
+			else { shallow.push_back({ first.Current(), first.Leaf() }); }
+		}
+		if (task.size() >= want || task.empty() || Stopped()) { break; }
+	}
+	auto report([&](const Soln& rows, const Count leaf)
+	{
+		found += leaf;
+		CallBack(Event::Soln);
+		if (ShowSoln) { ShowSoln(rows); }
+	});
+	for (const auto& s : shallow) { report(s.rows, s.leaf); }
+
+	// round robin over the lanes, a lane done with its subtree takes the next
+	size_t next(0);
+	vector<DLX2*> busy;
+	for (auto& d : _lane) {
+		if (next == task.size()) { break; }
+		d->BeginSteps(task[next++], forbid, bulk, 0, true);
+		busy.push_back(d.get());
+	}
+	while (!busy.empty()) {
+		for (size_t k(0); k < busy.size();) {
+			DLX2& d(*busy[k]);
+			const DLX2::Stop s(d.Step());
+			if (DLX2::Stop::Soln == s) { report(d.Current(), d.Leaf()); }
+			if (DLX2::Stop::Done != s) { ++k; continue; }
+			if (next < task.size() && !Stopped()) {
+				d.BeginSteps(task[next++], forbid, bulk, 0, true);
+				++k;
+			}
+			else { busy.erase(busy.begin() + k); }
+		}
+	}
+	CallBack(Event::End);
+}
@@ -0,0 +1,35 @@
+// interleaved dlx2 solver: several subtree searches take turns on one thread to overlap their cache misses
+// Bill Ola Rasmussen
+#pragma once
+
+#include "Solver.h"
+#include "ProblemMatrix.h"
+#include "dlx2.h"
+#include <vector>
+#include <memory>
+
+// On large problems DLX2 spends much of its time waiting for the dependent
+// loads of Cover and Uncover. One search can not do anything useful while
+// it waits, but another one, on its own copy of the structure, can. The
+// search tree is cut at the shallowest depth giving enough subtrees, then
+// each lane, a DLX2 built from the same problem, searches one subtree after
+// another, taking one step per turn: before a row is taken it walks down
+// the row's columns one node per turn, prefetching the next node and the
+// neighbours Cover relinks, and yields, see DLX2::Step. The lanes take
+// turns round robin, so by the time a lane comes back its data has had the
+// other lanes' steps to arrive. Where the structures fit the caches the
+// extra turns only cost time, see benchInterleave.py.
+//
+// Solutions of different subtrees are reported in the order the lanes find
+// them, not in the order of a plain DLX2 search. Costs one structure per
+// lane. Settings of this solver are passed on to the lanes, except check.
+class ILX : public Solver {
+	std::vector<std::unique_ptr<DLX2>> _lane;
+	void Settings(DLX2& d) const;
+public:
+	ILX(const ProblemMatrix& pm, const unsigned int lanes);
+	void Solve(Show ShowSoln, std::function<void(Event)>CallBack) override;
+	void SolveAssuming(const Soln& require, const Soln& forbid, Show ShowSoln, std::function<void(Event)>CallBack) override;
+	ILX& operator=(const ILX&) = delete;
+	ILX(const ILX&) = delete;
+};
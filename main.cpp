@@ -1,11 +1,15 @@
 // read data and run solver
 // Bill Ola Rasmussen
 
-#include "dlx.h"
-#include "dlx2.h"
-#include "dix.h"
-#include "acx.h"
-#include "axt.h"
+#include "Solvers.h"
+#include "ilx.h"
+#include "SolnStream.h"
+#include "Server.h"
+#include "Pruner.h"
+#include "PerfCounters.h"
+#include "Endgame.h"
+#include "Inflate.h"
+#include "Autotune.h"
 #include <iostream>
 #include <iomanip>
 #include <string>
@@ -16,80 +20,178 @@
 #include <ctime>
 #include <chrono>
 #include <memory>
+#include <map>
+#include <limits>
+#include <cstdint>
+#include <algorithm>
 using namespace std;
 
-// observer pattern
-void CallBack(const Solver::Event e)
-{
-	static chrono::high_resolution_clock::time_point begin;
-	static bool first(true);
-	static int count(0);
-	
-	if(e==Solver::Event::Begin)
-	{
-		begin=chrono::high_resolution_clock::now();
-		cout<<"event: begin\n";
-	}
-	if(e==Solver::Event::Soln)
+// observer pattern: progress report of one solver, its found count is the total
+// perf: optional hardware counters around the search
+class Progress {
+	const Solver& _solver;
+	PerfCounters* _perf;
+	chrono::high_resolution_clock::time_point _begin;
+	bool _first = true;
+public:
+	Progress(const Solver& solver, PerfCounters* perf) :_solver(solver), _perf(perf) {}
+	void operator()(const Solver::Event e)
 	{
-		++count;
-		if(first)
+		if(e==Solver::Event::Begin)
+		{
+			_begin=chrono::high_resolution_clock::now();
+			_first=true; // a solver may be run several times, see -queries
+			cout<<"event: begin\n";
+			if(_perf){_perf->Start();}
+		}
+		if(e==Solver::Event::Soln&&_first)
 		{
 			const auto soln(chrono::high_resolution_clock::now());
-			first=false;
-			const auto d(chrono::duration_cast<chrono::milliseconds>(soln-begin));
+			_first=false;
+			const auto d(chrono::duration_cast<chrono::milliseconds>(soln-_begin));
 			cout<<"time to first solution: "<<d.count()/1000.<<" seconds\n";
 		}
+		if(e==Solver::Event::End)
+		{
+			if(_perf){_perf->Stop();}
+			const auto end(chrono::high_resolution_clock::now());
+			const auto d(chrono::duration_cast<chrono::milliseconds>(end-_begin));
+			cout<<_solver.FoundText()<<" solution(s) found, full solve time: "<<d.count()/1000.<<" seconds\n";
+			if(_perf){_perf->Report(cout,"search");}
+		}
 	}
-	if(e==Solver::Event::End)
+};
+
+ProblemMatrix readInput(const string& inputsrc)
+{
+	filebuf fb;
+	if ("cin" != inputsrc && !fb.open(inputsrc, ios::in | ios::binary)) { throw(runtime_error("unable to open input file: " + inputsrc)); }
+	InflateBuf ib("cin" == inputsrc ? cin.rdbuf() : &fb); // gzip and zstd input are detected and decompressed
+	if (InflateBuf::Format::Plain != ib.Detected()) { cout << "input is " << ib.Name() << " compressed\n"; }
+	istream is(&ib);
+	is.exceptions(ios::badbit); // decompression errors reach the caller
+	return ReadProblem(is);
+}
+
+// options follow the positional parameters, form: -name=value or -name
+using Options = map<string, string>;
+
+Options readOptions(int argc, char *argv[], int first)
+{
+	Options options;
+	for (int i(first); i < argc; ++i)
 	{
-		const auto end(chrono::high_resolution_clock::now());
-		const auto d(chrono::duration_cast<chrono::milliseconds>(end-begin));
-		cout<<count<<" solution(s) found, full solve time: "<<d.count()/1000.<<" seconds\n";
+		const string arg(argv[i]);
+		if (arg.size() < 2 || '-' != arg[0]) { throw(runtime_error("bad option: " + arg)); }
+		const auto eq(arg.find('='));
+		options[arg.substr(1, eq - 1)] = string::npos == eq ? "" : arg.substr(eq + 1);
 	}
+	return options;
+}
+
+// remove an option from the list, return its value or the default if not present
+string takeOption(Options& options, const string& name, const string& def)
+{
+	const auto it(options.find(name));
+	if (options.end() == it) { return def; }
+	const string value(it->second);
+	options.erase(it);
+	return value;
+}
+
+// an option value that must be a whole number, up to 9 digits, no sign or trailing text
+unsigned int number(const string& name, const string& value)
+{
+	const bool digits(!value.empty() && value.size() <= 9 && all_of(value.begin(), value.end(), [](const char c) { return '0' <= c && c <= '9'; }));
+	if (!digits) { throw(runtime_error("bad -" + name + ": " + value)); }
+	return stoul(value);
+}
+
+// remove a numeric option from the list, return its value or the default if not present
+unsigned int takeNumber(Options& options, const string& name, const unsigned int def)
+{
+	if (!options.count(name)) { return def; }
+	return number(name, takeOption(options, name, ""));
+}
+
+// remove a valueless option from the list, return true if it was present
+bool takeFlag(Options& options, const string& name)
+{
+	return options.erase(name) > 0;
+}
+
+// query line: required row numbers, optionally followed by | and forbidden row numbers
+// returns false for blank and # comment lines
+bool readQuery(const string& line, Solver::Soln& require, Solver::Soln& forbid)
+{
+	require.clear();
+	forbid.clear();
+	const auto hash(line.find('#'));
+	const string text(line.substr(0, hash));
+	if (string::npos == text.find_first_not_of(" \t\r")) { return false; }
+	const auto bar(text.find('|'));
+	istringstream in(text.substr(0, bar)), out(string::npos == bar ? "" : text.substr(bar + 1));
+	for (unsigned int r; in >> r;) { require.emplace_back(r); }
+	if (!in.eof()) { throw(runtime_error("bad query: " + line)); }
+	for (unsigned int r; out >> r;) { forbid.emplace_back(r); }
+	if (!out.eof()) { throw(runtime_error("bad query: " + line)); }
+	return true;
+}
+
+Solver::Propagate propagateOption(const string& value)
+{
+	if ("off" == value) { return Solver::Propagate::Off; }
+	if ("forced" == value) { return Solver::Propagate::Forced; }
+	if ("rows" == value) { return Solver::Propagate::Rows; }
+	throw(runtime_error("unknown propagate mode: " + value));
+}
+
+Solver::Order orderOption(const string& value)
+{
+	if ("input" == value) { return Solver::Order::Input; }
+	if ("eliminate" == value) { return Solver::Order::Eliminate; }
+	if ("learned" == value) { return Solver::Order::Learned; }
+	throw(runtime_error("unknown row order: " + value));
 }
 
-void readInput(Solver&solver, istream&is)
+Solver::Check checkOption(const string& value)
 {
-	string str;
-	{ // read constraint counts (columns)
-		while (is.good())
+	if ("off" == value) { return Solver::Check::Off; }
+	if ("sum" == value) { return Solver::Check::Sum; }
+	if ("full" == value) { return Solver::Check::Full; }
+	throw(runtime_error("unknown check mode: " + value));
+}
+
+// daemon mode: solve --serve socket [-workers=N], protocol in Server.h
+int serve(int argc, char *argv[])
+{
+	cout << "Exact Cover Solver\n";
+	try
+	{
+		if (argc < 3) { throw(runtime_error("usage: solve --serve socket [-workers=N]")); }
+		Options options(readOptions(argc, argv, 3));
+		const unsigned int workers(takeNumber(options, "workers", 0));
+		if (!options.empty()) { throw(runtime_error("unknown option: " + options.begin()->first)); }
+		Serve(argv[2], workers, readInput, [](const ProblemMatrix& pm, const string& name, ostream& out) -> Solver*
 		{
-			getline(is, str);
-			if (str.length() && '[' == str[0]) { break; }
-		}
-		getline(is, str);
-		stringstream ss(str);
-		int pri, sec;
-		ss >> pri >> sec;
-		if (ss.fail()) { throw(runtime_error("fail reading constraint counts")); }
-		cout << "primary constraints: " << pri << ", "
-			<< "secondary constraints: " << sec << '\n';
-
-		solver.Init(pri, sec);
+			const auto make(Solvers().find(name));
+			if (Solvers().end() == make) { throw runtime_error("unknown solver: " + name); }
+			return make->second(pm, 0, out);
+		});
 	}
-	while(is.good()) // read lines (rows)
+	catch (exception const&e)
 	{
-		getline(is,str);
-		if(str.length()&&str[0]==']')
-		{
-			// while (is.good()) { getline(is, str); } // empty stream
-			return;
-		}
-		stringstream ss(str);
-		for(bool first(true);!ss.eof();first=false) // read numbers (columns)
-		{
-			int col;
-			ss>>col;
-			if(ss.bad()||ss.fail()){break;} // eof is ok
-			first?solver.Row(col):solver.Col(col);
-		}
+		cout << "Exception: " << e.what() << '\n';
 	}
-	throw(runtime_error("no closing bracket in input"));
+	cout << "done.\n";
+
+	return 0;
 }
 
 int main(int argc, char *argv[])
 {
+	if (argc > 1 && string("--serve") == argv[1]) { return serve(argc, argv); }
+
 	// 1st parameter: -q for quiet
 	string flag(argc > 1 ? argv[1] : "");
 	flag.resize(2);
@@ -98,35 +200,131 @@ int main(int argc, char *argv[])
 	// 2nd parameter: name of input file, blank or cin for cin
 	const string inputsrc(argc > 2 ? argv[2] : "cin");
 
-	// 3rd parameter: solver name, blank for default dlx
+	// 3rd parameter: solver name, blank for default dlx, auto to choose by probing, see Autotune.h
 	const string solverName(argc > 3 ? argv[3] : "dlx");
 
+	// 4th and later parameters: options
+	//	-check=off|sum|full		structure integrity verification, default off
+	//	-index=auto|16|32|64	index width of dix, acx and dcx, default auto: narrowest that fits
+	//	-propagate=off|forced|rows	dlx2 and dix: reduce after each choice, default off
+	//	-order=input|eliminate|learned	dlx2: order of the rows tried in the chosen column, default input, see Solver.h
+	//	-prune=area				dlx2 and dix: prune branches using problem metadata, see Pruner.h
+	//	-cheapest=K				dix: branch and bound for the K covers of least total row cost, needs row costs in the input
+	//	-interleave=N			dlx2: N subtree searches take turns on one thread, hiding memory latency, see ilx.h
+	//	-endgame=N				dlx2 and dix: bitmask search once N or fewer primary columns are open, 0 off, default 0
+	//	-split=N				dix: every N levels, search the open columns apart when they fall into parts sharing no rows, 0 off, default 0
+	//	-soln=file				also write solutions to file as binary solution stream, see SolnStream.h
+	//	-loadonly				read input and build solver, skip search, used to benchmark loading
+	//	-queries=file			instead of one full search, run one search per query line of file
+	//							form: required rows [| forbidden rows], 0 based input row numbers
+	//	-perf					hardware performance counters per phase: load, build, search (Linux)
+	//	-tune=file				auto: cache of solver choices by problem shape, default solve.tune
+	//							auto sets the solver, propagate and endgame
+
 	cout << "Exact Cover Solver\n";
 	try
 	{
-		unique_ptr<Solver> solver;
-		if (solverName == "dlx") { solver.reset(new DLX()); }
-		else if (solverName == "dlx2") { solver.reset(new DLX2()); }
-		else if (solverName == "dix") { solver.reset(new DIX()); }
-		else if (solverName == "acx") { solver.reset(new ACX()); } // note!: acx implementation not yet working
-		else if (solverName == "axt") { solver.reset(new AXT()); } // note: in progress...
-		else { throw runtime_error("unknown solver: " + solverName); }
+		Options options(readOptions(argc, argv, 4));
+		const Solver::Check check(checkOption(takeOption(options, "check", "off")));
+		Solver::Propagate propagate(propagateOption(takeOption(options, "propagate", "off")));
+		if (Solver::Propagate::Off != propagate && "dlx2" != solverName && "dix" != solverName) { throw(runtime_error("propagation is for dlx2 and dix only")); }
+		const Solver::Order order(orderOption(takeOption(options, "order", "input")));
+		if (Solver::Order::Input != order && "dlx2" != solverName) { throw(runtime_error("row order is for dlx2 only")); }
+		const string pruner(takeOption(options, "prune", ""));
+		if (!pruner.empty() && "dlx2" != solverName && "dix" != solverName) { throw(runtime_error("pruning is for dlx2 and dix only")); }
+		const unsigned int cheapest(takeNumber(options, "cheapest", 0));
+		if (cheapest && "dix" != solverName) { throw(runtime_error("cheapest covers are found by dix only")); }
+		const bool endgameGiven(options.count("endgame"));
+		unsigned int endgame(takeNumber(options, "endgame", 0));
+		if (endgame > Endgame::BITS) { throw(runtime_error("endgame column count above " + to_string(Endgame::BITS))); }
+		if (endgameGiven && "dlx2" != solverName && "dix" != solverName) { throw(runtime_error("endgame is for dlx2 and dix only")); }
+		const unsigned int split(takeNumber(options, "split", 0));
+		if (split && "dix" != solverName) { throw(runtime_error("split search is for dix only")); }
+		const unsigned int interleave(takeNumber(options, "interleave", 0));
+		if (interleave && "dlx2" != solverName) { throw(runtime_error("interleaved search is for dlx2 only")); }
+		const string index(takeOption(options, "index", "auto"));
+		const unsigned int indexBits("auto" == index ? 0 : number("index", index));
+		const bool loadOnly(takeFlag(options, "loadonly"));
+		const string solnPath(takeOption(options, "soln", ""));
+		const string queryPath(takeOption(options, "queries", ""));
+		unique_ptr<PerfCounters> perf(takeFlag(options, "perf") ? new PerfCounters : nullptr);
+		const string tuneCache(takeOption(options, "tune", "solve.tune"));
+		if (!options.empty()) { throw(runtime_error("unknown option: " + options.begin()->first)); }
+
+		const bool tune("auto" == solverName);
+		auto make(Solvers().find(solverName));
+		if (Solvers().end() == make && !tune) { throw runtime_error("unknown solver: " + solverName); }
 
 		cout << "reading input from " << inputsrc << "...\n";
-		if ("cin" == inputsrc)
+		if (perf) { perf->Start(); }
+		const auto loadBegin(chrono::high_resolution_clock::now());
+		const ProblemMatrix pm(readInput(inputsrc));
+		const auto load(chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - loadBegin));
+		if (perf) { perf->Stop(); }
+		cout << "input read time: " << load.count() / 1000. << " seconds\n";
+		if (perf) { perf->Report(cout, "load"); }
+
+		if (tune)
 		{
-			readInput(*solver, cin);
+			const Tuning t(Autotune(pm, quiet && solnPath.empty(), tuneCache, [&](const ProblemMatrix& p, const string& name, ostream& out)
+			{
+				return Solvers().at(name)(p, indexBits, out);
+			}));
+			make = Solvers().find(t.solver);
+			if (Solvers().end() == make) { throw runtime_error("unknown solver in tuning cache: " + t.solver); }
+			propagate = t.propagate;
+			endgame = t.endgame;
 		}
-		else // input from file
+
+		if (perf) { perf->Start(); }
+		const auto buildBegin(chrono::high_resolution_clock::now());
+		unique_ptr<Solver> solver(interleave ? new ILX(pm, interleave) : make->second(pm, indexBits, cout));
+		solver->check = check;
+		solver->propagate = propagate;
+		solver->order = order;
+		solver->endgame = endgame;
+		solver->split = split;
+		solver->cheapest = cheapest;
+		if (!pruner.empty()) { solver->prune = MakePruner(pruner, pm); }
+		const auto build(chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - buildBegin));
+		if (perf) { perf->Stop(); }
+		cout << "build time: " << build.count() / 1000. << " seconds\n";
+		if (perf) { perf->Report(cout, "build"); }
+
+		ofstream solnFile;
+		unique_ptr<SolnWriter> writer;
+		if (!solnPath.empty())
 		{
-			filebuf fb;
-			fb.open(inputsrc, ios::in);
-			istream is(&fb);
-			readInput(*solver, is);
-			fb.close();
+			solnFile.open(solnPath, ios::binary);
+			if (!solnFile) { throw(runtime_error("unable to open solution file: " + solnPath)); }
+			writer.reset(new SolnWriter(solnFile));
+		}
+		Solver::Show show;
+		if (!quiet || writer)
+		{
+			show = [&](const Solver::Soln& soln)
+			{
+				if (!quiet) { WriteText(cout, pm, soln); }
+				if (writer) { writer->Write(soln); }
+			};
 		}
 
-		solver->Solve(!quiet, CallBack);
+		if (loadOnly) { cout << "search skipped\n"; }
+		else if (!queryPath.empty())
+		{
+			// one built solver answers all queries, it restores its structure after each
+			ifstream queries(queryPath);
+			if (!queries) { throw(runtime_error("unable to open query file: " + queryPath)); }
+			Solver::Soln require, forbid;
+			for (string line; getline(queries, line);)
+			{
+				if (!readQuery(line, require, forbid)) { continue; }
+				cout << "query: " << line << '\n';
+				solver->SolveAssuming(require, forbid, show, Progress(*solver, perf.get()));
+			}
+		}
+		else { solver->Solve(show, Progress(*solver, perf.get())); }
+		if (writer) { writer->Close(); } // write last block
 	}
 	catch (exception const&e)
 	{
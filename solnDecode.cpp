@@ -0,0 +1,54 @@
+// decode a binary solution stream to the text solution format
+// Bill Ola Rasmussen
+
+// usage: solnDecode {problem file} {solution file or cin}
+// The problem file is the solver input, it maps row numbers to columns.
+
+#include "ProblemMatrix.h"
+#include "SolnStream.h"
+#include "Inflate.h"
+#include <iostream>
+#include <fstream>
+#include <stdexcept>
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2) {
+		cerr << "usage: " << argv[0] << " {problem file} [solution file]\n";
+		return 1;
+	}
+	try
+	{
+		filebuf fb;
+		if (!fb.open(argv[1], ios::in | ios::binary)) { throw(runtime_error(string("unable to open problem file: ") + argv[1])); }
+		InflateBuf ib(&fb); // the problem file may be gzip or zstd compressed
+		istream problem(&ib);
+		problem.exceptions(ios::badbit);
+		streambuf* out(cout.rdbuf());
+		cout.rdbuf(cerr.rdbuf()); // loader progress messages to stderr, keep stdout for solutions
+		const ProblemMatrix pm(ReadProblem(problem));
+		cout.rdbuf(out);
+
+		const string solnsrc(argc > 2 ? argv[2] : "cin");
+		ifstream file;
+		if ("cin" != solnsrc) {
+			file.open(solnsrc, ios::binary);
+			if (!file) { throw(runtime_error("unable to open solution file: " + solnsrc)); }
+		}
+		SolnReader reader("cin" == solnsrc ? cin : file);
+		Solver::Soln soln;
+		while (reader.Read(soln)) {
+			for (const auto& r : soln) {
+				if (r >= pm.Rows()) { throw(runtime_error("row number out of range")); }
+			}
+			WriteText(cout, pm, soln);
+		}
+	}
+	catch (exception const&e)
+	{
+		cerr << "Exception: " << e.what() << '\n';
+		return 1;
+	}
+	return 0;
+}
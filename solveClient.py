@@ -0,0 +1,45 @@
+#!/usr/bin/env python3
+# Minimal client for the solver daemon: solve --serve socket
+# Bill Ola Rasmussen
+# version 1.0
+
+# Sends request lines from stdin (or the command line) to the daemon and
+# prints replies as they arrive. Exits once every request has its final
+# reply, see Server.h for the protocol. Example:
+#   solve --serve /tmp/ec.sock &
+#   printf 'load q8 q8.txt\ncount a q8\nfirst b q8 2 require=0\n' | solveClient.py /tmp/ec.sock
+
+import socket
+import sys
+
+FINAL=('loaded','unloaded','done','error') # replies that end a request
+
+def expectsReply(line):
+    'true if request gets a final reply: all except cancel, shutdown, blank and comments'
+    words=line.split()
+    return bool(words) and words[0] not in ('cancel','shutdown') and not words[0].startswith('#')
+
+def run(path,requests):
+    s=socket.socket(socket.AF_UNIX,socket.SOCK_STREAM)
+    s.connect(path)
+    pending=0
+    for line in requests:
+        s.sendall((line.rstrip('\n')+'\n').encode())
+        if expectsReply(line):
+            pending+=1
+    f=s.makefile('r')
+    while pending:
+        reply=f.readline()
+        if not reply:
+            raise RuntimeError('connection closed with {} request(s) pending'.format(pending))
+        sys.stdout.write(reply)
+        sys.stdout.flush()
+        if reply.split()[0] in FINAL:
+            pending-=1
+    s.close()
+
+if __name__=='__main__':
+    if len(sys.argv)<2:
+        print('usage: solveClient.py socket [request ...], requests from stdin if none given')
+        sys.exit(1)
+    run(sys.argv[1],sys.argv[2:] or sys.stdin.readlines())
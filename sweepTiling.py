@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+# Count Y pentomino tilings of whole board sweeps with the tmx solver
+# Bill Ola Rasmussen
+# version 1.0
+
+# For each width, one tmx run on a width x length board counts the tilings
+# of every width x k board, k up to length, see tmx.h. With -check, boards
+# of at most that many cells are also counted with dlx2 and compared.
+# Example:
+#   sweepTiling.py ./solve 5-11 60 -check 200
+
+import contextlib
+import os
+import subprocess
+import sys
+import tempfile
+import CreateYpentominoData
+
+def createInput(fileName,w,h):
+    with open(fileName,'w') as f, contextlib.redirect_stdout(f):
+        CreateYpentominoData.exactCoverSpec(w,h)
+
+def run(solve,fileName,solver):
+    'solver output lines, raise on a reported exception'
+    out=subprocess.run([solve,'-q',fileName,solver],
+                       stdout=subprocess.PIPE,universal_newlines=True).stdout
+    if 'Exception:' in out:
+        raise RuntimeError(solver+' failed:\n'+out)
+    return out.splitlines()
+
+def sweep(solve,fileName,w,length):
+    'tilings of w x k boards, k=1..length, from one tmx run'
+    createInput(fileName,w,length)
+    counts={}
+    for line in run(solve,fileName,'tmx'):
+        f=line.split()
+        if line.startswith('tmx:') and 'lines' in f: # tmx: k lines of w: count
+            counts[int(f[1])]=int(f[5])
+    return counts
+
+def count(solve,fileName,w,h):
+    'tilings of a w x h board counted by dlx2'
+    createInput(fileName,w,h)
+    for line in run(solve,fileName,'dlx2'):
+        if 'solution(s) found' in line:
+            return int(line.split()[0])
+    raise RuntimeError('no solution count in dlx2 output')
+
+def widths(arg):
+    'n or first-last'
+    first,_,last=arg.partition('-')
+    return range(int(first),int(last or first)+1)
+
+if __name__ == "__main__":
+    args=sys.argv[1:]
+    check=0
+    if '-check' in args:
+        i=args.index('-check')
+        check=int(args[i+1])
+        del args[i:i+2]
+    if len(args)!=3:
+        print('usage: '+sys.argv[0]+' solve width[-width] length [-check cells]')
+        sys.exit(1)
+    solve,length=args[0],int(args[2])
+    with tempfile.TemporaryDirectory() as d:
+        fileName=os.path.join(d,'input.txt')
+        for w in widths(args[1]):
+            if length<w:
+                raise ValueError('length below width '+str(w)+': tmx would sweep the other side')
+            for k,n in sorted(sweep(solve,fileName,w,length).items()):
+                line='%d x %d: %d'%(w,k,n)
+                if w*k<=check:
+                    m=count(solve,fileName,w,k)
+                    if m!=n:
+                        raise RuntimeError(line+' but dlx2 counts '+str(m))
+                    line+=' (dlx2 agrees)'
+                print(line)
@@ -0,0 +1,225 @@
+// transfer matrix solver: count tilings of a rectangular board by a frontier dynamic program
+// Bill Ola Rasmussen
+
+#include "tmx.h"
+#include <stdexcept>
+#include <iostream>
+#include <algorithm>
+#include <limits>
+using namespace std;
+
+namespace {
+
+// Counts of all states, each a little endian multiword integer of the same
+// number of words. Widened when a top word gets close to overflowing, a
+// step adds far fewer than 2^32 counts into one state.
+class Counts {
+	size_t _words = 1;
+	vector<uint64_t> _w;
+public:
+	size_t Words() const { return _words; }
+	void Clear(const size_t states, const size_t words)
+	{
+		_words = words;
+		_w.assign(states * _words, 0);
+	}
+	void Append() { _w.resize(_w.size() + _words); } // one more state, count zero
+	uint64_t* operator[](const size_t s) { return &_w[s * _words]; }
+	const uint64_t* operator[](const size_t s) const { return &_w[s * _words]; }
+	void Add(const size_t to, const uint64_t* from)
+	{
+		uint64_t* const p((*this)[to]);
+		uint64_t carry(0);
+		for (size_t i(0); i < _words; ++i) {
+			const uint64_t a(p[i] + carry);
+			carry = a < carry;
+			p[i] = a + from[i];
+			carry += p[i] < a;
+		}
+	}
+	void Widen() // keep headroom in the top word
+	{
+		bool high(false);
+		for (size_t s(0); s < _w.size() && !high; s += _words) { high = _w[s + _words - 1] >> 32; }
+		if (!high) { return; }
+		vector<uint64_t> w(_w.size() / _words * (_words + 1));
+		for (size_t s(0), t(0); s < _w.size(); s += _words, t += _words + 1) { copy(&_w[s], &_w[s] + _words, &w[t]); }
+		++_words;
+		_w.swap(w);
+	}
+};
+
+// Position of each state in the list of next states. Open addressing over a
+// power of two table, half full at most. A state never has its top bit set,
+// it was shifted right, so all ones marks a free slot.
+const TMX::Mask FREE(~TMX::Mask(0));
+const size_t NONE(~size_t(0));
+
+class Index {
+	typedef TMX::Mask Mask;
+	vector<Mask> _key;
+	vector<size_t> _at;
+	size_t _used = 0;
+	unsigned int _shift = 64;
+	size_t Slot(const Mask m) const
+	{
+		size_t i(size_t(m * 0x9e3779b97f4a7c15ull >> _shift)); // Fibonacci hashing, high bits
+		while (FREE != _key[i] && m != _key[i]) { i = (i + 1) & (_key.size() - 1); }
+		return i;
+	}
+public:
+	void Clear(const size_t expect)
+	{
+		size_t n(16);
+		_shift = 60;
+		while (n < 2 * expect) { n *= 2; --_shift; }
+		_key.assign(n, FREE);
+		_at.resize(n);
+		_used = 0;
+	}
+	size_t Find(const Mask m) const
+	{
+		const size_t i(Slot(m));
+		return FREE == _key[i] ? NONE : _at[i];
+	}
+	size_t Insert(const Mask m, const size_t at) // position of m, at if new
+	{
+		size_t i(Slot(m));
+		if (FREE != _key[i]) { return _at[i]; }
+		if (2 * (_used + 1) > _key.size()) { // grow and place the old keys again
+			vector<Mask> key;
+			vector<size_t> pos;
+			key.swap(_key);
+			pos.swap(_at);
+			Clear(key.size());
+			for (size_t j(0); j < key.size(); ++j) {
+				if (FREE == key[j]) { continue; }
+				const size_t k(Slot(key[j]));
+				_key[k] = key[j];
+				_at[k] = pos[j];
+				++_used;
+			}
+			i = Slot(m);
+		}
+		_key[i] = m;
+		_at[i] = at;
+		++_used;
+		return at;
+	}
+};
+
+string Decimal(const uint64_t* p, const size_t words)
+{
+	vector<uint32_t> n; // 32 bit words, most significant first, so 64 bit arithmetic divides
+	for (size_t i(words); i--;) { n.push_back(uint32_t(p[i] >> 32)); n.push_back(uint32_t(p[i])); }
+	string s;
+	for (;;) {
+		uint64_t rem(0);
+		bool zero(true);
+		for (auto& d : n) {
+			const uint64_t x(rem << 32 | d);
+			d = uint32_t(x / 1000000000);
+			rem = x % 1000000000;
+			zero = zero && !d;
+		}
+		for (int i(0); i < 9; ++i, rem /= 10) { s.insert(s.begin(), char('0' + rem % 10)); }
+		if (zero) { break; }
+	}
+	const auto first(s.find_first_not_of('0'));
+	return string::npos == first ? "0" : s.substr(first);
+}
+
+Solver::Count Saturate(const uint64_t* p, const size_t words)
+{
+	Solver::Count v(0);
+	for (size_t i(words); i--;) {
+		if (v >> (sizeof(v) * 8 - 64)) { return numeric_limits<Solver::Count>::max(); }
+		v = v << 32 << 32 | p[i];
+	}
+	return v;
+}
+
+} // namespace
+
+// ---------- build data structure from input ----------
+
+TMX::TMX(const ProblemMatrix& pm)
+{
+	const unsigned long w(pm.MetaNumber("width")), h(pm.MetaNumber("height"));
+	if (w * h != pm.Primary()) { throw(runtime_error("tmx: board size does not match primary constraints")); }
+	if (pm.Secondary()) { throw(runtime_error("tmx: secondary constraints are not supported")); }
+	const bool rows(w <= h); // scan line by line along the longer side
+	_across = rows ? w : h;
+	_along = rows ? h : w;
+	_piece.resize(w * h);
+	vector<unsigned long> cell;
+	for (ProblemMatrix::TI r(0); r < pm.Rows(); ++r) {
+		cell.clear();
+		for (auto p(pm.RowBegin(r)); p != pm.RowEnd(r); ++p) {
+			const unsigned long x(*p % w), y(*p / w);
+			cell.push_back(rows ? *p : y + h * x);
+		}
+		const auto first(*min_element(cell.begin(), cell.end()));
+		Mask m(0);
+		for (const auto& c : cell) {
+			if (c - first >= 64) { throw(runtime_error("tmx: piece spans more than 64 cells in scan order, board too wide")); }
+			m |= Mask(1) << (c - first);
+		}
+		_piece[first].push_back(m);
+	}
+}
+
+// ---------- solve ----------
+
+void TMX::Solve(Show ShowSoln, std::function<void(Event)>CallBack)
+{
+	if (ShowSoln) { throw(runtime_error("tmx counts solutions without listing them, run with -q and without -soln")); }
+	*out << "TMX with " << _across << " cells across, " << _along << " along the scan\n";
+	found = 0;
+	_total = "0";
+	CallBack(Event::Begin);
+	vector<Mask> state(1, 0), next; // cells from the current one on already covered
+	Counts count, sum;
+	count.Clear(1, 1);
+	count[0][0] = 1;
+	Index index; // of each next state
+	size_t most(1);
+	for (size_t p(0); p < _piece.size() && !Stopped(); ++p) {
+		next.clear();
+		index.Clear(state.size());
+		sum.Clear(0, count.Words());
+		auto to([&](const Mask m, const size_t from)
+		{
+			const size_t at(index.Insert(m, next.size()));
+			if (next.size() == at) {
+				next.push_back(m);
+				sum.Append();
+			}
+			sum.Add(at, count[from]);
+		});
+		for (size_t s(0); s < state.size(); ++s) {
+			const Mask m(state[s]);
+			if (m & 1) { to(m >> 1, s); continue; } // covered already, pass over it
+			for (const auto& q : _piece[p]) {
+				if (!(m & q)) { to((m | q) >> 1, s); } // place a piece starting here
+			}
+		}
+		sum.Widen();
+		state.swap(next);
+		swap(count, sum);
+		most = max(most, state.size());
+		if (!((p + 1) % _across)) { // end of a line: the empty state counts the tilings so far
+			const size_t zero(index.Find(0));
+			const string n(NONE == zero ? "0" : Decimal(count[zero], count.Words()));
+			const auto lines((p + 1) / _across);
+			*out << "tmx: " << lines << " lines of " << _across << ": " << n << '\n';
+			if (_piece.size() == p + 1) {
+				_total = n;
+				if (NONE != zero) { found = Saturate(count[zero], count.Words()); }
+			}
+		}
+	}
+	*out << "tmx: most states at one cell: " << most << '\n';
+	if (found) { CallBack(Event::Soln); }
+	CallBack(Event::End);
+}
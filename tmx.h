@@ -0,0 +1,41 @@
+// transfer matrix solver: count tilings of a rectangular board by a frontier dynamic program
+// Bill Ola Rasmussen
+#pragma once
+
+#include "Solver.h"
+#include "ProblemMatrix.h"
+#include <vector>
+#include <cstdint>
+#include <string>
+
+// Counts the solutions of a board tiling problem without searching them. It
+// needs the "meta: width=W height=H" line written by CreateYpentominoData.py,
+// the primary columns are the board cells, cell x,y is column x+W*y, and no
+// secondary columns. The rows may be any pieces.
+//
+// Cells are visited line by line along the longer side of the board, so the
+// frontier runs across the shorter side. In any tiling, the first cell not
+// yet covered is covered by a piece whose first cell it is, so the state at
+// a cell is the set of cells from there on already covered, a Mask of the
+// next Span cells, and the count of partial tilings reaching it. Each step
+// either passes over a covered cell or places a piece starting at the
+// first open cell. The states at the end of each line count the tilings of
+// the shorter boards, reported as a length sweep along the way. Time is
+// linear in the board length for a fixed width, the number of states grows
+// exponentially with the width instead.
+//
+// Counts are exact at any size, kept as multiword integers; found saturates
+// when the total does not fit a Count, FoundText has the exact value.
+class TMX : public Solver {
+public:
+	typedef std::uint64_t Mask;
+	explicit TMX(const ProblemMatrix& pm);
+	void Solve(Show ShowSoln, std::function<void(Event)>CallBack) override;
+	std::string FoundText() const override { return _total; }
+	TMX& operator=(const TMX&) = delete;
+	TMX(const TMX&) = delete;
+private:
+	unsigned long _across, _along; // board size across and along the scan
+	std::vector<std::vector<Mask>> _piece; // pieces starting at each cell in scan order, cells relative to it
+	std::string _total;
+};